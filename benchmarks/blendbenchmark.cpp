@@ -0,0 +1,151 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include <QImage>
+
+#include "imageblender.h"
+#include "blendkernels.h"
+#include "workerpool.h"
+
+//This program times ImageBlender at 720p, 1080p and 4K.  It compares the original blend (pixel by pixel, column by
+//column, with doubles) to the row-by-row kernels with each instruction set the CPU supports, and checks that every
+//version makes exactly the same image.
+
+static const int samplesPerFrame = 16;
+static const int repeats = 5;
+
+
+
+
+
+//The blend that ImageBlender used before the kernels were added, kept here as the reference.
+static QImage referenceBlend(const QVector<QImage> & images)
+{
+    QSize imageSize = images[0].size();
+    QImage blendedImage(imageSize, QImage::Format_RGB32);
+    double count = double(images.size());
+
+    for (int i = 0; i < imageSize.width(); i++)
+    {
+        for (int j = 0; j < imageSize.height(); j++)
+        {
+            double redTotal = 0, greenTotal = 0, blueTotal = 0;
+            for (int k = 0; k < images.size(); k++)
+            {
+                QRgb pixelColor = images[k].pixel(i, j);
+                redTotal += qRed(pixelColor);
+                greenTotal += qGreen(pixelColor);
+                blueTotal += qBlue(pixelColor);
+            }
+            blendedImage.setPixel(i, j, qRgb(int(redTotal/count+0.5), int(greenTotal/count+0.5), int(blueTotal/count+0.5)));
+        }
+    }
+
+    return blendedImage;
+}
+
+
+
+
+
+//Makes a set of noisy images, so that every rounding case comes up.
+static QVector<QImage> makeImages(QSize size)
+{
+    QVector<QImage> images;
+    quint32 seed = 12345;
+    for (int k = 0; k < samplesPerFrame; k++)
+    {
+        QImage image(size, QImage::Format_RGB32);
+        for (int j = 0; j < size.height(); j++)
+        {
+            QRgb * line = reinterpret_cast<QRgb *>(image.scanLine(j));
+            for (int i = 0; i < size.width(); i++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                line[i] = 0xff000000u | (seed >> 8);
+            }
+        }
+        images.append(image);
+    }
+    return images;
+}
+
+
+
+
+
+//Blends the images with ImageBlender, returning the best time of several runs in milliseconds.
+static double timeBlender(const QVector<QImage> & images, bool accumulate, QImage * result)
+{
+    ImageBlender blender;
+    double bestTime = 1.0e30;
+
+    for (int r = 0; r < repeats; r++)
+    {
+        blender.initialize(images.size(), accumulate);
+        QElapsedTimer timer;
+        timer.start();
+        for (int k = 0; k < images.size(); k++)
+            blender.addImage(images[k], k);
+        *result = blender.blendImages();
+        bestTime = qMin(bestTime, timer.nsecsElapsed() / 1.0e6);
+    }
+
+    return bestTime;
+}
+
+
+
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QVector<QSize> sizes;
+    sizes << QSize(1280, 720) << QSize(1920, 1080) << QSize(3840, 2160);
+    bool allMatch = true;
+
+    out << "Best supported instruction set: "
+        << BlendKernels::instructionSetName(BlendKernels::bestSupportedInstructionSet()) << Qt::endl;
+    out << "Worker threads: " << WorkerPool::threadCount() << Qt::endl;
+    out << samplesPerFrame << " samples per frame, best of " << repeats << " runs" << Qt::endl << Qt::endl;
+
+    for (int s = 0; s < sizes.size(); s++)
+    {
+        QVector<QImage> images = makeImages(sizes[s]);
+        out << sizes[s].width() << "x" << sizes[s].height() << Qt::endl;
+
+        QElapsedTimer timer;
+        timer.start();
+        QImage reference = referenceBlend(images);
+        double referenceTime = timer.nsecsElapsed() / 1.0e6;
+        out << "    reference (column-major, doubles): " << QString::number(referenceTime, 'f', 2) << " ms" << Qt::endl;
+
+        for (int set = BlendKernels::scalarInstructions; set <= BlendKernels::bestSupportedInstructionSet(); set++)
+        {
+            BlendKernels::InstructionSet instructionSet = BlendKernels::InstructionSet(set);
+            BlendKernels::setInstructionSet(instructionSet);
+
+            for (int mode = 0; mode < 2; mode++)
+            {
+                QImage result;
+                double time = timeBlender(images, mode == 1, &result);
+                bool match = (result == reference);
+                allMatch = allMatch && match;
+
+                out << "    " << BlendKernels::instructionSetName(instructionSet).leftJustified(7)
+                    << (mode == 1 ? "accumulate: " : "stored:     ")
+                    << QString::number(time, 'f', 2) << " ms, "
+                    << QString::number(referenceTime / time, 'f', 1) << "x"
+                    << (match ? "" : "  MISMATCH") << Qt::endl;
+            }
+        }
+        out << Qt::endl;
+    }
+
+    out << (allMatch ? "All results match the reference." : "Some results differ from the reference!") << Qt::endl;
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Microbenchmark for the image blending kernels.  Build it in release mode and run it from a terminal.
+#
+#-------------------------------------------------
+
+QT       += core gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = blendbenchmark
+TEMPLATE = app
+
+include(../core/core.pri)
+
+SOURCES += blendbenchmark.cpp
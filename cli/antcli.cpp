@@ -0,0 +1,481 @@
+#include <QGuiApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+
+#include "antsimulation.h"
+#include "renderpipeline.h"
+#include "framewriter.h"
+#include "rulesearch.h"
+#include "jobqueue.h"
+#include "workerpool.h"
+#include "searchengine.h"
+
+//This program renders an animation or runs a pattern search without the GUI, using a settings file saved by the
+//animator.  Usage:
+//
+//  antcli render <settings.las> <output> [--threads N] [--frames FIRST-LAST] [--checkpoints DIRECTORY]
+//  antcli checkpoints <settings.las> <checkpoint directory> <interval>
+//  antcli search <settings.las> <output directory> <all | pattern count> [--threads N]
+//                [--shard I/N | --range FIRST-LAST] [--seed S]
+//  antcli queue <output directory> [settings.las ...] [--cores N] [--memory MB]
+//
+//The output of a render is a directory, or a file (or "-" for standard output, except for packed deltas) for the stream
+//formats.  A search tries every rule for the number of states ("all") or the given number of random ones, and saves an
+//image of each, trying as many rules at once as there are threads.  --shard runs the Ith of N equal parts of the search
+//(counting from 0), and --range runs the rules (or for a random search, the draws) with indexes FIRST to LAST.  The seed
+//is printed at the start, and with --seed a search makes exactly the same rules and colors again, so shards run by
+//different processes or machines cover the search with no overlap and their results can be put together afterwards.
+//Each result gives the rule's class (growing, escaped, highway, periodic or bounded) and when it was found, and the
+//search exits setting decides which classes stop a rule early.  --threads sets how many threads blend and save; by
+//default every core is used.  --frames renders just the frames from FIRST to LAST, so a long render can be split between
+//processes or machines.  The checkpoints command runs the simulation alone and saves a checkpoint every interval frames,
+//and a render with --checkpoints starts from the latest one before its first frame instead of from time 0.  The frames
+//come out exactly as they would in one render.  A range can't be rendered when the main output or any extra output is
+//in a stream format, as a stream can't be joined up afterwards.  The queue renders each settings file into a directory
+//(or stream file) named after it, running as many at once as fit in the cores and memory given.  It keeps its state in
+//queue.txt in the output directory, so running it again carries on where it stopped, and more settings files can be
+//added to it at any time.  Progress goes to standard output (or standard error, when a render's stream is going to
+//standard output), one line per report, as a word followed by name=value pairs, e.g. "progress frame=12 written=10
+//total=100".  The last line is "done ...".  Errors go to standard error, and the program returns 1 if anything failed.
+
+static int render(AntSimulation * simulation, const QString & output, int threadCount, const QString & frameRange,
+                  const QString & checkpointDirectory, QTextStream & outputStream, QTextStream & errorStream)
+{
+    AntSettings * settings = &(simulation->settings);
+
+    //A stream written to standard output can't have reports mixed into it, so they go to standard error instead
+    QTextStream & reportStream = (output == "-") ? errorStream : outputStream;
+    if ( (output == "-")&&(settings->outputFormat == FrameWriter::packedDeltaFormat) )
+    {
+        errorStream << "The packed delta format can't be written to standard output" << Qt::endl;
+        return 1;
+    }
+
+    //The whole animation is rendered unless a range is given
+    int firstFrame = 0;
+    int lastFrame = -1;
+    int totalFrames = settings->frameCount;
+    if (!frameRange.isEmpty())
+    {
+        QStringList range = frameRange.split('-');
+        bool firstValid = false;
+        bool lastValid = false;
+        if (range.size() == 2)
+        {
+            firstFrame = range[0].toInt(&firstValid);
+            lastFrame = range[1].toInt(&lastValid);
+        }
+        if ( (!firstValid)||(!lastValid)||(firstFrame < 0)||(lastFrame < firstFrame)||(lastFrame > settings->frameCount) )
+        {
+            errorStream << "The frame range must be FIRST-LAST, within 0-" << settings->frameCount << Qt::endl;
+            return 1;
+        }
+        if (RenderPipeline::hasStreamOutput(settings))
+        {
+            errorStream << "A range of frames can't be rendered when any output is in a stream format" << Qt::endl;
+            return 1;
+        }
+        if ( (firstFrame == 0)&&(!settings->saveZeroFrame) )
+            firstFrame = 1;
+        totalFrames = lastFrame - firstFrame + 1;
+    }
+
+    //The stream formats go into a single file.  Anything else needs the directory to exist.
+    if ( (!FrameWriter::isStreamFormat(settings->outputFormat))&&(!QDir().mkpath(output)) )
+    {
+        errorStream << "Couldn't make the directory " << output << Qt::endl;
+        return 1;
+    }
+
+    QMutex gridMutex;
+    RenderPipeline renderPipeline(simulation->displayGrid, simulation->antGrid, simulation->antCounter, settings, &gridMutex);
+    renderPipeline.setWriterThreadCount(threadCount);
+
+    //A range that starts part way through needs the simulation, and the camera, moved on to the frame before it
+    simulation->resetToStart();
+    if (firstFrame > 1)
+    {
+        Camera camera;
+        simulation->resetCamera(&camera);
+        Camera * followingCamera = settings->followPattern ? &camera : 0;
+
+        int startFrame = 1;
+        if (checkpointDirectory.isEmpty())
+            simulation->skipFrames(1, firstFrame, followingCamera);
+        else
+            startFrame = simulation->restoreFromCheckpoints(checkpointDirectory, firstFrame, followingCamera);
+        reportStream << "start frame=" << firstFrame << " from=" << startFrame << " time=" << settings->time << Qt::endl;
+
+        renderPipeline.setStartingCamera(camera);
+    }
+    renderPipeline.startRender(output, firstFrame, lastFrame);
+
+    //The pipeline runs on its own threads, so just report on it until it's done
+    int frameNumber = 0;
+    int frameTime = 0;
+    while (!renderPipeline.wait(500))
+    {
+        renderPipeline.takeFrame(&frameNumber, &frameTime);
+        reportStream << "progress frame=" << frameNumber << " time=" << frameTime << " written=" << renderPipeline.framesWritten()
+                     << " total=" << totalFrames << Qt::endl;
+    }
+
+    int failures = renderPipeline.failedFrameCount();
+    reportStream << "done frames=" << renderPipeline.framesWritten() << " failed=" << failures
+                 << " completed=" << (renderPipeline.renderCompleted() ? 1 : 0) << Qt::endl;
+
+    if ( (failures > 0)||(!renderPipeline.renderCompleted()) )
+        return 1;
+    return 0;
+}
+
+
+
+
+
+static int writeCheckpoints(AntSimulation * simulation, const QString & directory, int interval, QTextStream & outputStream,
+                            QTextStream & errorStream)
+{
+    AntSettings * settings = &(simulation->settings);
+
+    if (!QDir().mkpath(directory))
+    {
+        errorStream << "Couldn't make the directory " << directory << Qt::endl;
+        return 1;
+    }
+
+    //There's no need for a checkpoint at frame 1, as that is time 0
+    simulation->resetToStart();
+    Camera camera;
+    simulation->resetCamera(&camera);
+    Camera * followingCamera = settings->followPattern ? &camera : 0;
+
+    int checkpointCount = 0;
+    for (int frameNumber = 1 + interval; frameNumber <= settings->frameCount; frameNumber += interval)
+    {
+        simulation->skipFrames(frameNumber - interval, frameNumber, followingCamera);
+
+        QString fileName = AntSimulation::checkpointFileName(directory, frameNumber);
+        if (!simulation->saveCheckpoint(fileName, frameNumber, followingCamera))
+        {
+            errorStream << "Couldn't write " << fileName << Qt::endl;
+            return 1;
+        }
+        checkpointCount++;
+
+        outputStream << "checkpoint frame=" << frameNumber << " time=" << settings->time << " total=" << settings->frameCount
+                     << " file=" << fileName << Qt::endl;
+    }
+
+    outputStream << "done checkpoints=" << checkpointCount << Qt::endl;
+    return 0;
+}
+
+
+
+
+
+static int search(AntSimulation * simulation, const QString & output, const QString & searchArgument, int threadCount,
+                  const QString & shardOption, const QString & rangeOption, const QString & seedOption,
+                  QTextStream & outputStream, QTextStream & errorStream)
+{
+    AntSettings * settings = &(simulation->settings);
+    StateRule * stateRules = simulation->stateRules;
+
+    if (settings->stateCount < 3)
+    {
+        errorStream << "Three or more states are necessary to run a search" << Qt::endl;
+        return 1;
+    }
+
+    //An "all" search goes through a fixed number of rules, and a random one goes on for as many as were asked for
+    int searchType = RuleSearch::randomSearch;
+    quint64 maxPatternCount = searchArgument.toULongLong();
+    if (searchArgument == "all")
+    {
+        int maxStateCount = RuleSearch::maxStateCountForAll(settings->includeBack);
+        if (settings->stateCount > maxStateCount)
+        {
+            errorStream << "The state count must be " << maxStateCount << " or fewer to run an \"all\" search" << Qt::endl;
+            return 1;
+        }
+        searchType = RuleSearch::allSearch;
+        maxPatternCount = RuleSearch::patternCountForAll(settings->stateCount, settings->includeBack);
+    }
+    else if (maxPatternCount == 0)
+    {
+        errorStream << "The search must be \"all\" or a number of patterns" << Qt::endl;
+        return 1;
+    }
+
+    //The search can be cut down to one shard, or to a range of indexes (or draws, for a random search)
+    quint64 firstPattern = 0;
+    quint64 patternsToTry = maxPatternCount;
+    if ( (!shardOption.isEmpty())&&(!rangeOption.isEmpty()) )
+    {
+        errorStream << "Only one of --shard and --range can be given" << Qt::endl;
+        return 1;
+    }
+    if (!shardOption.isEmpty())
+    {
+        QStringList shard = shardOption.split('/');
+        bool shardValid = false;
+        bool countValid = false;
+        int shardNumber = 0;
+        int shardCount = 0;
+        if (shard.size() == 2)
+        {
+            shardNumber = shard[0].toInt(&shardValid);
+            shardCount = shard[1].toInt(&countValid);
+        }
+        if ( (!shardValid)||(!countValid)||(shardCount < 1)||(shardNumber < 0)||(shardNumber >= shardCount) )
+        {
+            errorStream << "The shard must be I/N, with I from 0 to N-1" << Qt::endl;
+            return 1;
+        }
+        RuleSearch::shardRange(maxPatternCount, shardNumber, shardCount, &firstPattern, &patternsToTry);
+    }
+    if (!rangeOption.isEmpty())
+    {
+        QStringList range = rangeOption.split('-');
+        bool firstValid = false;
+        bool lastValid = false;
+        quint64 lastPattern = 0;
+        if (range.size() == 2)
+        {
+            firstPattern = range[0].toULongLong(&firstValid);
+            lastPattern = range[1].toULongLong(&lastValid);
+        }
+        if ( (!firstValid)||(!lastValid)||(lastPattern < firstPattern)||(lastPattern >= maxPatternCount) )
+        {
+            errorStream << "The range must be FIRST-LAST, within 0-" << (maxPatternCount - 1) << Qt::endl;
+            return 1;
+        }
+        patternsToTry = lastPattern - firstPattern + 1;
+    }
+
+    quint64 seed = 0;
+    bool seedValid = false;
+    if (!seedOption.isEmpty())
+    {
+        seed = seedOption.toULongLong(&seedValid);
+        if (!seedValid)
+        {
+            errorStream << "The seed must be a whole number" << Qt::endl;
+            return 1;
+        }
+    }
+
+    if (!QDir().mkpath(output))
+    {
+        errorStream << "Couldn't make the directory " << output << Qt::endl;
+        return 1;
+    }
+
+    //Every thread tries rules and saves their images.  The results are reported in order as they come in.
+    SearchEngine searchEngine;
+    searchEngine.setFirstPattern(firstPattern);
+    if (seedValid)
+        searchEngine.setSeed(seed);
+    if (patternsToTry > 0)
+        searchEngine.start(*settings, stateRules, searchType, patternsToTry, output, threadCount);
+    outputStream << "search first=" << firstPattern << " count=" << patternsToTry << " total=" << maxPatternCount
+                 << " seed=" << searchEngine.seed() << Qt::endl;
+    quint64 patternCount = 0;
+    bool finished = false;
+    while (!finished)
+    {
+        finished = searchEngine.wait(500);
+        QVector<SearchEngine::Result> results = searchEngine.takeResults();
+        for (int i = 0; i < results.size(); i++)
+        {
+            outputStream << "result " << SearchEngine::describeResult(results[i]) << " total=" << maxPatternCount << Qt::endl;
+            patternCount++;
+        }
+    }
+
+    int failures = searchEngine.failedCount();
+    outputStream << "done patterns=" << patternCount << " failed=" << failures << Qt::endl;
+
+    if (failures > 0)
+        return 1;
+    return 0;
+}
+
+
+
+
+
+static int runQueue(const QStringList & arguments, int coreBudget, qint64 memoryBudget, QTextStream & outputStream,
+                    QTextStream & errorStream)
+{
+    QString outputDirectory = arguments[2];
+    if (!QDir().mkpath(outputDirectory))
+    {
+        errorStream << "Couldn't make the directory " << outputDirectory << Qt::endl;
+        return 1;
+    }
+
+    JobQueue queue;
+    queue.setBudget(memoryBudget, coreBudget);
+    QString stateFile = outputDirectory + QDir::separator() + "queue.txt";
+    if (QFileInfo(stateFile).exists())
+        queue.loadState(stateFile);
+
+    //Add the settings files that aren't in the queue already
+    for (int i = 3; i < arguments.size(); i++)
+    {
+        QString settingsFile = QFileInfo(arguments[i]).absoluteFilePath();
+        bool alreadyQueued = false;
+        for (int j = 0; j < queue.jobs.size(); j++)
+        {
+            if (queue.jobs[j]->settingsFile == settingsFile)
+                alreadyQueued = true;
+        }
+        if (!alreadyQueued)
+            queue.addJob(settingsFile, outputDirectory + QDir::separator() + QFileInfo(settingsFile).completeBaseName());
+    }
+
+    if (queue.jobs.isEmpty())
+    {
+        errorStream << "There are no jobs in the queue" << Qt::endl;
+        return 1;
+    }
+
+    for (int i = 0; i < queue.jobs.size(); i++)
+    {
+        RenderJob * job = queue.jobs[i];
+        outputStream << "job index=" << i << " status=" << RenderJob::statusName(job->status) << " memory=" << job->memoryNeeded
+                     << " cores=" << job->coresNeeded << " settings=" << job->settingsFile << Qt::endl;
+    }
+
+    //Report on the running jobs, and on any that have just stopped, until there is nothing left to do
+    QVector<RenderJob::Status> lastStatus(queue.jobs.size(), RenderJob::waitingJob);
+    queue.start();
+    while (true)
+    {
+        queue.update();
+        for (int i = 0; i < queue.jobs.size(); i++)
+        {
+            RenderJob * job = queue.jobs[i];
+            if ( (job->status == RenderJob::runningJob)||(job->status != lastStatus[i]) )
+            {
+                outputStream << "progress job=" << i << " status=" << RenderJob::statusName(job->status) << " frames=" << job->framesDone
+                             << " total=" << job->frameTotal;
+                if (!job->message.isEmpty())
+                    outputStream << " message=" << job->message;
+                outputStream << Qt::endl;
+            }
+            lastStatus[i] = job->status;
+        }
+        queue.saveState(stateFile);
+
+        if (queue.isFinished())
+            break;
+        QThread::msleep(500);
+    }
+
+    int failedJobs = queue.jobCount(RenderJob::failedJob);
+    outputStream << "done finished=" << queue.jobCount(RenderJob::finishedJob) << " failed=" << failedJobs << Qt::endl;
+
+    if (failedJobs > 0)
+        return 1;
+    return 0;
+}
+
+
+
+
+
+//This function takes an option and its value out of the arguments, so the rest are left in fixed places.  It returns
+//the value, or an empty string if the option isn't there.
+static QString takeOption(QStringList * arguments, const QString & name)
+{
+    int index = arguments->indexOf(name);
+    if ( (index <= 0)||(index + 1 >= arguments->size()) )
+        return "";
+
+    QString value = (*arguments)[index + 1];
+    arguments->removeAt(index + 1);
+    arguments->removeAt(index);
+    return value;
+}
+
+
+
+
+
+int main(int argc, char *argv[])
+{
+    //The counter and rules are drawn with fonts, which needs QtGui, but there is no screen on a compute node
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication a(argc, argv);
+    QStringList arguments = a.arguments();
+    QTextStream outputStream(stdout);
+    QTextStream errorStream(stderr);
+
+    //Take out the options first
+    int threadCount = QThread::idealThreadCount();
+    QString threadOption = takeOption(&arguments, "--threads");
+    if (threadOption.isEmpty())
+        threadOption = takeOption(&arguments, "--cores");
+    if (!threadOption.isEmpty())
+        threadCount = qMax(1, threadOption.toInt());
+    QString frameRange = takeOption(&arguments, "--frames");
+    QString checkpointDirectory = takeOption(&arguments, "--checkpoints");
+    QString shardOption = takeOption(&arguments, "--shard");
+    QString rangeOption = takeOption(&arguments, "--range");
+    QString seedOption = takeOption(&arguments, "--seed");
+    qint64 memoryBudget = qint64(4096) * 1024 * 1024;
+    QString memoryOption = takeOption(&arguments, "--memory");
+    if (!memoryOption.isEmpty())
+        memoryBudget = qint64(qMax(1, memoryOption.toInt())) * 1024 * 1024;
+
+    bool renderCommand = ( (arguments.size() == 4)&&(arguments[1] == "render") );
+    bool searchCommand = ( (arguments.size() == 5)&&(arguments[1] == "search") );
+    bool queueCommand = ( (arguments.size() >= 3)&&(arguments[1] == "queue") );
+    bool checkpointsCommand = ( (arguments.size() == 5)&&(arguments[1] == "checkpoints")&&(arguments[4].toInt() > 0) );
+    if ( (!renderCommand)&&(!searchCommand)&&(!queueCommand)&&(!checkpointsCommand) )
+    {
+        errorStream << "Usage: antcli render <settings.las> <output directory | stream file | -> [--threads N]" << Qt::endl;
+        errorStream << "                     [--frames FIRST-LAST] [--checkpoints DIRECTORY]" << Qt::endl;
+        errorStream << "       antcli checkpoints <settings.las> <checkpoint directory> <interval>" << Qt::endl;
+        errorStream << "       antcli search <settings.las> <output directory> <all | pattern count> [--threads N]" << Qt::endl;
+        errorStream << "                     [--shard I/N | --range FIRST-LAST] [--seed S]" << Qt::endl;
+        errorStream << "       antcli queue <output directory> [settings.las ...] [--cores N] [--memory MB]" << Qt::endl;
+        return 1;
+    }
+
+    if (queueCommand)
+    {
+        WorkerPool::setThreadCount(threadCount);
+        return runQueue(arguments, threadCount, memoryBudget, outputStream, errorStream);
+    }
+
+    AntSimulation simulation;
+    if (!simulation.loadSettings(arguments[2]))
+    {
+        errorStream << "Couldn't read " << arguments[2] << Qt::endl;
+        return 1;
+    }
+
+    WorkerPool::setThreadCount(threadCount);
+
+    if (renderCommand)
+    {
+        simulation.create();
+        return render(&simulation, arguments[3], threadCount, frameRange, checkpointDirectory, outputStream, errorStream);
+    }
+    if (checkpointsCommand)
+    {
+        simulation.create();
+        return writeCheckpoints(&simulation, arguments[3], arguments[4].toInt(), outputStream, errorStream);
+    }
+    return search(&simulation, arguments[3], arguments[4], threadCount, shardOption, rangeOption, seedOption, outputStream,
+                  errorStream);
+}
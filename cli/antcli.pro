@@ -0,0 +1,18 @@
+#-------------------------------------------------
+#
+# Command line tool that renders animations and runs pattern searches without the GUI.
+#
+#-------------------------------------------------
+
+QT       += core gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = antcli
+TEMPLATE = app
+
+include(../core/core.pri)
+
+SOURCES += antcli.cpp
+
+unix:QMAKE_CXXFLAGS += -std=c++11
@@ -0,0 +1,400 @@
+#include "antcounter.h"
+#include <cstring>
+
+AntCounter::AntCounter(Grid *displayGridP, AntSettings *settingsP, StateRule *stateArrayP)
+{
+    //Store the pointers to the Grid and AntSettings objects and the StateRule array
+    displayGrid = displayGridP;
+    settings = settingsP;
+    stateArray = stateArrayP;
+
+    //initialize the max values to zero
+    maxWidthSoFar = 0;
+    maxHeightSoFar = 0;
+
+    //Nothing has been drawn into the caches yet
+    atlasMade = false;
+    glyphHeight = 0;
+    rulesBoxLocation = -1;
+
+    //Set up the pen that will be used to draw the outlines around the counter and rules
+    pen.setWidth(2);
+    pen.setJoinStyle(Qt::MiterJoin);
+}
+
+
+
+void AntCounter::paintCountAndRules()
+{
+    paintedArea = QRect();
+
+    //Remake the glyph atlas if the font has changed since it was made
+    if ( (!atlasMade)||(atlasFont != settings->counterFont) )
+        makeAtlas();
+
+    //Draw the counter onto the image, if that setting is on
+    if (settings->showCounter)
+        paintCounter();
+
+    //Draw the rules onto the image, if that setting is on
+    if (settings->showRules)
+        paintRules();
+}
+
+
+
+
+
+//This function draws each character that the counter can show into its own small image, using the counter font.
+//The images are the advance width of the character, so they can be placed side by side to make up a number.
+void AntCounter::makeAtlas()
+{
+    QFontMetrics fontMetrics(settings->counterFont);
+    glyphHeight = fontMetrics.height();
+
+    const char characters[] = "0123456789,";
+    for (int i = 0; i < 11; i++)
+    {
+        QString character = QString(QChar(characters[i]));
+
+        glyphs[i] = QImage(qMax(1, fontMetrics.horizontalAdvance(character)), glyphHeight, QImage::Format_RGB32);
+        glyphs[i].fill(QColor(255,255,255));
+
+        QPainter glyphPainter(&glyphs[i]);
+        glyphPainter.setPen(pen);
+        glyphPainter.setFont(settings->counterFont);
+        glyphPainter.drawText(0, fontMetrics.ascent(), character);
+    }
+
+    atlasFont = settings->counterFont;
+    atlasMade = true;
+
+    //The boxes depend on the font, so they have to be remade as well
+    counterBox = QImage();
+    rulesBox = QImage();
+}
+
+
+
+
+
+void AntCounter::paintCounter()
+{
+    //Break the time into glyphs, from the last digit to the first, putting a comma after every third digit.  An int
+    //has at most 10 digits, so 16 glyphs is plenty.
+    int glyphList[16];
+    int glyphCount = 0;
+    int remainingTime = qMax(0, settings->time);
+    int digitCount = 0;
+    do
+    {
+        if ( (digitCount > 0)&&(digitCount % 3 == 0) )
+            glyphList[glyphCount++] = 10; //comma
+        glyphList[glyphCount++] = remainingTime % 10;
+        remainingTime /= 10;
+        digitCount++;
+    } while (remainingTime > 0);
+
+    int textWidth = 0;
+    for (int i = 0; i < glyphCount; i++)
+        textWidth += glyphs[glyphList[i]].width();
+
+    //Ensure that the size hasn't gotten any smaller!  The size of the counter box is only allowed to grow until it is reset.
+    int boxTextWidth = qMax(textWidth, maxWidthSoFar);
+    int boxTextHeight = qMax(glyphHeight, maxHeightSoFar);
+    maxWidthSoFar = boxTextWidth;
+    maxHeightSoFar = boxTextHeight;
+
+    //Remake the empty box if it has grown
+    if ( (counterBox.isNull())||(counterBoxTextSize != QSize(boxTextWidth, boxTextHeight)) )
+    {
+        counterBox = makeBox(boxTextWidth, boxTextHeight);
+        counterBoxTextSize = QSize(boxTextWidth, boxTextHeight);
+    }
+
+    QRect outlineRect = placeOutline(boxTextWidth, boxTextHeight, settings->counterLocation);
+    copyBoxToImage(counterBox, outlineRect);
+
+    //The text sits 4 pixels inside the outline, against the left or right side depending on the corner
+    int x;
+    if ( (settings->counterLocation == 1)||(settings->counterLocation == 3) )
+        x = outlineRect.right() - 3 - textWidth;
+    else
+        x = outlineRect.left() + 4;
+    int y = outlineRect.top() + 4;
+
+    for (int i = glyphCount - 1; i >= 0; i--)
+    {
+        copyGlyphToImage(glyphs[glyphList[i]], x, y);
+        x += glyphs[glyphList[i]].width();
+    }
+}
+
+
+
+
+
+//The rules only change when the user changes them, so the whole box is drawn once and then copied onto each image.
+void AntCounter::paintRules()
+{
+    if (!rulesBoxIsCurrent())
+    {
+        QString ruleText = getStateList();
+        QFontMetrics fontMetrics(settings->counterFont);
+        QRect textRect = fontMetrics.boundingRect(ruleText);
+
+        rulesBoxOutline = placeOutline(textRect.width(), textRect.height(), settings->rulesLocation);
+        rulesBox = makeBox(textRect.width(), textRect.height());
+
+        //Enlarge the text rectangle a bit so the text is less likely to be cut-off
+        textRect.setWidth(textRect.width()+8);
+
+        //Paint the text onto the box.  In the box image, the outline's top-left corner is at (2, 2).
+        QPainter boxPainter(&rulesBox);
+        boxPainter.setPen(pen);
+        boxPainter.setFont(settings->counterFont);
+        if ( (settings->rulesLocation == 1)||(settings->rulesLocation == 3) )
+        {
+            textRect.moveTopRight(QPoint(2 + rulesBoxOutline.width() - 1 - 4, 6));
+            boxPainter.drawText(textRect, Qt::AlignRight, ruleText);
+        }
+        else
+        {
+            textRect.moveTopLeft(QPoint(6, 6));
+            boxPainter.drawText(textRect, Qt::AlignLeft, ruleText);
+        }
+
+        //Remember what the box was made from, so we know when it needs to be remade
+        rulesBoxDirections.resize(settings->stateCount);
+        for (int i = 0; i < settings->stateCount; i++)
+            rulesBoxDirections[i] = stateArray[i].direction;
+        rulesBoxFont = settings->counterFont;
+        rulesBoxLocation = settings->rulesLocation;
+        rulesBoxImageSize = displayGrid->gridImage->size();
+    }
+
+    copyBoxToImage(rulesBox, rulesBoxOutline);
+}
+
+
+
+
+
+bool AntCounter::rulesBoxIsCurrent()
+{
+    if (rulesBox.isNull())
+        return false;
+    if ( (rulesBoxLocation != settings->rulesLocation)||(rulesBoxFont != settings->counterFont) )
+        return false;
+    if (rulesBoxImageSize != displayGrid->gridImage->size())
+        return false;
+    if (rulesBoxDirections.size() != settings->stateCount)
+        return false;
+    for (int i = 0; i < settings->stateCount; i++)
+    {
+        if (rulesBoxDirections[i] != stateArray[i].direction)
+            return false;
+    }
+    return true;
+}
+
+
+
+
+
+//This function returns the outline rectangle for a box holding text of the given size, moved to the correct corner
+//of the image.
+QRect AntCounter::placeOutline(int textWidth, int textHeight, int location)
+{
+    QRect outlineRect(0, 0, textWidth+10, textHeight+8);
+
+    switch (location)
+    {
+    case 0: //top-left corner
+        outlineRect.moveTopLeft(QPoint(16, 16));
+        break;
+    case 1: //top-right corner
+        outlineRect.moveTopRight(QPoint(displayGrid->gridImage->width()-16, 16));
+        break;
+    case 2: //bottom-left corner
+        outlineRect.moveBottomLeft(QPoint(16, displayGrid->gridImage->height()-16));
+        break;
+    case 3: //bottom-right corner
+        outlineRect.moveBottomRight(QPoint(displayGrid->gridImage->width()-16, displayGrid->gridImage->height()-16));
+        break;
+    }
+
+    return outlineRect;
+}
+
+
+
+
+
+//This function draws an empty box (white with an outline) into a transparent image.  The image has a 2 pixel margin
+//around the outline rectangle, as the outline's pen is 2 pixels wide and spills over the rectangle's edge.
+QImage AntCounter::makeBox(int textWidth, int textHeight)
+{
+    QImage box(textWidth+10+4, textHeight+8+4, QImage::Format_ARGB32_Premultiplied);
+    box.fill(Qt::transparent);
+
+    QRect outlineRect(2, 2, textWidth+10, textHeight+8);
+    QPainter boxPainter(&box);
+    boxPainter.setPen(pen);
+    boxPainter.fillRect(outlineRect, QColor(255,255,255));
+    boxPainter.drawRect(outlineRect);
+
+    return box;
+}
+
+
+
+
+
+//This function copies a box image made by makeBox onto the grid's image, so that its outline rectangle lands on the
+//passed rectangle.  Transparent pixels are skipped and partly transparent ones are blended.
+void AntCounter::copyBoxToImage(const QImage & box, QRect outlineRect)
+{
+    QImage * image = displayGrid->gridImage;
+    int left = outlineRect.left() - 2;
+    int top = outlineRect.top() - 2;
+    paintedArea |= QRect(left, top, box.width(), box.height());
+
+    for (int j = qMax(0, -top); j < box.height(); j++)
+    {
+        if (top + j >= image->height())
+            break;
+
+        const QRgb * sourceLine = reinterpret_cast<const QRgb *>(box.constScanLine(j));
+        QRgb * destinationLine = reinterpret_cast<QRgb *>(image->scanLine(top + j));
+
+        for (int i = qMax(0, -left); i < box.width(); i++)
+        {
+            if (left + i >= image->width())
+                break;
+
+            QRgb source = sourceLine[i];
+            int alpha = qAlpha(source);
+            if (alpha == 255)
+                destinationLine[left + i] = source;
+            else if (alpha > 0)
+            {
+                QRgb destination = destinationLine[left + i];
+                int inverse = 255 - alpha;
+                destinationLine[left + i] = qRgb(qRed(source) + (qRed(destination) * inverse + 127) / 255,
+                                                 qGreen(source) + (qGreen(destination) * inverse + 127) / 255,
+                                                 qBlue(source) + (qBlue(destination) * inverse + 127) / 255);
+            }
+        }
+    }
+}
+
+
+
+
+
+//This function copies a glyph onto the grid's image with its top-left corner at (x, y).  Glyphs are opaque (black
+//text on white) so they are copied a row at a time.
+void AntCounter::copyGlyphToImage(const QImage & glyph, int x, int y)
+{
+    QImage * image = displayGrid->gridImage;
+
+    int firstColumn = qMax(0, -x);
+    int lastColumn = qMin(glyph.width(), image->width() - x);
+    if (lastColumn <= firstColumn)
+        return;
+
+    for (int j = qMax(0, -y); j < glyph.height(); j++)
+    {
+        if (y + j >= image->height())
+            break;
+
+        const QRgb * sourceLine = reinterpret_cast<const QRgb *>(glyph.constScanLine(j));
+        QRgb * destinationLine = reinterpret_cast<QRgb *>(image->scanLine(y + j));
+        memcpy(destinationLine + x + firstColumn, sourceLine + firstColumn, sizeof(QRgb) * (lastColumn - firstColumn));
+    }
+}
+
+
+
+
+
+QString AntCounter::addCommasToNumber(int numberNeedingCommas)
+{
+    QString numberString = QString::number(numberNeedingCommas);
+
+    for (int i = numberString.length() - 3; i > 0; i -= 3)
+        numberString.insert(i, ",");
+
+    return numberString;
+}
+
+
+
+
+
+QString AntCounter::getStateList()
+{
+    QString stateList = "";
+    for (int i=0; i < settings->stateCount; i++)
+    {
+        switch (stateArray[i].direction)
+        {
+        case antRight:
+            stateList += "R";
+            break;
+        case antLeft:
+            stateList += "L";
+            break;
+        case antBack:
+            stateList += "B";
+            break;
+        }
+    }
+
+    return stateList;
+}
+
+
+
+
+void AntCounter::reset()
+{
+    maxWidthSoFar = 0;
+    maxHeightSoFar = 0;
+}
+
+
+
+
+//The counter box only grows, so a counter drawn part way through an animation has to start from the size the box
+//had reached by then.  These functions carry that size over from another counter or through a checkpoint.
+void AntCounter::copyBoxSize(const AntCounter & other)
+{
+    maxWidthSoFar = other.maxWidthSoFar;
+    maxHeightSoFar = other.maxHeightSoFar;
+}
+
+void AntCounter::writeCheckpoint(QDataStream & stream)
+{
+    stream << qint32(maxWidthSoFar) << qint32(maxHeightSoFar);
+}
+
+void AntCounter::readCheckpoint(QDataStream & stream)
+{
+    qint32 width, height;
+    stream >> width >> height;
+    maxWidthSoFar = width;
+    maxHeightSoFar = height;
+}
+
+
+
+
+//Since the stateArray pointer will change when the user alters the number of states (the array is actually
+//deleted and recreated), it is necessary to have this function so the new pointer can be given to the AntCounter
+//object.
+void AntCounter::updateStateArrayPointer(StateRule * stateArrayP)
+{
+    stateArray = stateArrayP;
+}
@@ -0,0 +1,65 @@
+#ifndef ANTCOUNTER_H
+#define ANTCOUNTER_H
+
+#include "grid.h"
+#include "antsettings.h"
+#include "staterule.h"
+
+class AntCounter
+{
+public:
+    AntCounter(Grid * displayGridP, AntSettings * settingsP, StateRule * stateArrayP);
+
+    void paintCountAndRules();
+    static QString addCommasToNumber(int numberNeedingCommas);
+    QString getStateList();
+    void reset();
+    void updateStateArrayPointer(StateRule * stateArrayP);
+    void copyBoxSize(const AntCounter & other);
+    void writeCheckpoint(QDataStream & stream);
+    void readCheckpoint(QDataStream & stream);
+
+    //The part of the image written to by the last call to paintCountAndRules
+    QRect paintedArea;
+
+private:
+    Grid * displayGrid;
+    AntSettings * settings;
+    StateRule * stateArray;
+
+    QPen pen;
+
+    int maxWidthSoFar;
+    int maxHeightSoFar;
+
+    //The glyph atlas: a pre-drawn image of each character the counter uses (the ten digits and a comma), made once
+    //per font.  The counter is drawn by copying these onto the grid instead of going through the font engine.
+    QFont atlasFont;
+    bool atlasMade;
+    QImage glyphs[11];
+    int glyphHeight;
+
+    //The empty counter box, kept until its size or location changes
+    QImage counterBox;
+    QSize counterBoxTextSize;
+    int counterBoxLocation;
+
+    //The whole rules box, kept until the rules, font or location change
+    QImage rulesBox;
+    QRect rulesBoxOutline;
+    QVector<AntDirection> rulesBoxDirections;
+    QFont rulesBoxFont;
+    int rulesBoxLocation;
+    QSize rulesBoxImageSize;
+
+    void makeAtlas();
+    void paintCounter();
+    void paintRules();
+    bool rulesBoxIsCurrent();
+    QRect placeOutline(int textWidth, int textHeight, int location);
+    QImage makeBox(int textWidth, int textHeight);
+    void copyBoxToImage(const QImage & box, QRect outlineRect);
+    void copyGlyphToImage(const QImage & glyph, int x, int y);
+};
+
+#endif // ANTCOUNTER_H
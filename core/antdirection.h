@@ -1,6 +1,6 @@
-#ifndef ANTDIRECTION_H
-#define ANTDIRECTION_H
-
-enum AntDirection {antRight = 1, antBack = 2, antLeft = 3};
-
-#endif // ANTDIRECTION_H
+#ifndef ANTDIRECTION_H
+#define ANTDIRECTION_H
+
+enum AntDirection {antRight = 1, antBack = 2, antLeft = 3};
+
+#endif // ANTDIRECTION_H
@@ -0,0 +1,760 @@
+#include "antgrid.h"
+#include "posterwriter.h"
+#include "workerpool.h"
+#include <QDataStream>
+#include <cstring>
+#include <cmath>
+
+AntGrid::AntGrid(Grid * displayGridP, AntSettings * settingsP, StateRule *stateArrayP)
+{
+    //Store the pointers to the Grid and AntSettings objects and the StateRule array
+    displayGrid = displayGridP;
+    settings = settingsP;
+    stateArray = stateArrayP;
+    pyramid = 0;
+    changeLogIndex = 0;
+    changeLogSample = 0;
+    changeLogSampleStart = 0;
+    tracingPath = false;
+
+    calculateGridSize();
+
+    //Dynamically create the 2D state array using the pointer to a pointer approach
+    state = new int * [columnCount];
+    for (int i=0; i<columnCount; i++)
+        state[i] = new int[rowCount];
+
+    //Place the ant at the starting location and set the state to zero everywhere.
+    resetGrid();
+
+    //SMALL ISSUE: THE calculateValues FUNCTION ACTUALLY GETS CALLED TWICE IN THE CONSTRUCTOR: ONCE DIRECTLY
+    //AND ONCE AS PART OF resetGrid.  IT'S NOT A REAL PROBLEM - JUST INEFFICIENT.  THE REASON IS IT HAS TO BE
+    //CALLED BEFORE THE ARRAY IS MADE AND ALSO HAS TO BE IN resetGrid BECAUSE CODE THAT TRIGGERS THAT SLOT
+    //SOMETIMES NEEDS THE STARTING POSITION TO BE UPDATED.
+
+}
+
+
+
+
+
+AntGrid::~AntGrid()
+{
+    delete pyramid;
+    delete [] changeLogIndex;
+
+    //Delete the 2D state array.
+    for (int i=0; i<columnCount; i++)
+        delete [] state[i];
+    delete [] state;
+}
+
+
+
+
+
+//This function loops through the whole grid and resets the states to zero.  It also moves the ant back to the starting position.
+void AntGrid::resetGrid()
+{
+    calculateStart();
+
+    //Place the ant at the starting location.
+    antX = startingColumn;
+    antY = startingRow;
+    antDirection = settings->startingDirection;
+
+    //Loop through the whole grid and set the state to zero everywhere.
+    for (int i = 0; i < columnCount; i++)
+    {
+        for (int j = 0; j < rowCount; j++)
+            state[i][j] = 0;
+    }
+
+    //Make sure the ant is labeled as being in range
+    outOfRange = false;
+
+    //Nothing has been changed yet, so the changed area is just the ant's cell
+    changedLeft = antX;
+    changedRight = antX;
+    changedTop = antY;
+    changedBottom = antY;
+
+    //The states have all changed, so the pyramid has to be recalculated
+    if (pyramid != 0)
+        pyramid->rebuild(settings->stateCount);
+
+    //If the setting is enabled to draw the ant, draw it now on the reset grid.
+    if (settings->showAntColor)
+    {
+        //Determine the coordinates of the square in display terms (i.e. without the buffer)
+        int displayX = antX - settings->gridBuffer;
+        int displayY = antY - settings->gridBuffer;
+
+        //It is not necessary to check here to see if the displayX and displayY variables are within a proper range - the Grid class
+        //does that check in the drawSquare function.
+        displayGrid->drawSquare(displayX, displayY, settings->antColor);
+    }
+}
+
+
+
+
+//This is a public function to return the state at a given row and column.  The main purpose of this function
+//is to account for the grid buffer.  Things calling this function just use the column and row of visible
+//squares - they don't need to know what the grid buffer is.
+int AntGrid::getState(int column, int row)
+{
+    return state[column+settings->gridBuffer][row+settings->gridBuffer];
+}
+
+
+
+
+
+//This function recreates the grid when its size changes.  It pretty much just deletes the state array and then
+//does all the same stuff as the constructor.  It doesn't need any arguments because it will get everything it
+//needs from the AntSettings and Grid objects - pointers to which this class already has.
+void AntGrid::resizeGrid()
+{
+    //The pyramid refers to the old state array, so it has to be remade too.  The same goes for the change log's
+    //index.
+    bool remakePyramid = (pyramid != 0);
+    setPyramidEnabled(false);
+    bool remakeChangeLog = (changeLogIndex != 0);
+    QRect oldChangeLogArea = changeLogArea;
+    setChangeLogEnabled(false);
+
+    //Delete the 2D state array.
+    for (int i=0; i<columnCount; i++)
+        delete [] state[i];
+    delete [] state;
+
+    calculateGridSize();
+
+    //Dynamically create the 2D state array using the pointer to a pointer approach
+    state = new int * [columnCount];
+    for (int i=0; i<columnCount; i++)
+        state[i] = new int[rowCount];
+
+    //Place the ant at the starting location and set the state to zero everywhere.
+    resetGrid();
+
+    setPyramidEnabled(remakePyramid);
+    setChangeLogEnabled(remakeChangeLog, oldChangeLogArea);
+}
+
+
+
+
+
+void AntGrid::calculateGridSize()
+{
+    //Determine the number of AntGrid columns and rows by adding the buffer to each end of both ranges.
+    columnCount = 2 * settings->gridBuffer + displayGrid->columnCount;
+    rowCount = 2 * settings->gridBuffer + displayGrid->rowCount;
+}
+void AntGrid::calculateStart()
+{
+    //Store the starting conditions in AntGrid terms (i.e. with the buffer added)
+    startingColumn = settings->startingColumn + settings->gridBuffer;
+    startingRow = settings->startingRow + settings->gridBuffer;
+}
+
+
+
+
+
+
+//This function does the real Langton's ant work: it moves the ant and makes the appropriate changes to
+//the AntGrid object as it goes.
+void AntGrid::moveAnt(int numberOfSteps, bool drawSquareAfterEachStep)
+{
+    stepAnt(numberOfSteps, drawSquareAfterEachStep);
+
+    //If the option to draw after each step is off, it is now necessary to redraw the entire image.
+    if (!drawSquareAfterEachStep)
+        drawAllSquares();
+}
+
+
+
+
+
+//This function moves the ant without drawing anything, for when only the states matter.  The image is left as it
+//was, so it has to be redrawn from the states before it is used again.
+void AntGrid::moveAntWithoutDrawing(int numberOfSteps)
+{
+    stepAnt(numberOfSteps, false);
+}
+
+
+
+
+
+//This function moves the ant for moveAnt and moveAntWithoutDrawing
+void AntGrid::stepAnt(int numberOfSteps, bool drawSquareAfterEachStep)
+{
+    //Advance the time.  This could be done one step at a time inside the above loop, but I chose not to for
+    //two reason.  First, this should slightly increase performance.  Secondly, when rendering animations
+    //to disk, I want to be able to have the counter continue even after the actual simulation has stopped
+    //due to the ant being out of range.
+    (settings->time) += numberOfSteps;
+
+    //Quit now if the ant is out of range.  This way the only thing that is done is the time being advanced.
+    if (outOfRange)
+        return;
+
+    //Variables to be used in the loop
+    AntDirection instruction;
+    int displayX, displayY;
+    int oldState;
+
+    //Execute this loop once per step the ant is to take
+    for (int i=0; i<numberOfSteps; i++)
+    {
+        //Record the step for the path trace, if it is on
+        if (tracingPath)
+        {
+            AntStep step;
+            step.x = antX;
+            step.y = antY;
+            step.direction = antDirection;
+            step.state = state[antX][antY];
+            pathTrace.append(step);
+        }
+
+        //Look up the direction the ant should turn based on its current square.
+        instruction = stateArray[ state[antX][antY] ].direction;
+
+        //Add the instuction to the ant's direction - i.e. rotate the ant the appropriate amount.
+        //The enum values of "instruction" can be automatically converted to an int for this addition.
+        antDirection += instruction;
+
+        //Make sure that the antDirection variable stays within the range of 0 to 3;
+        if (antDirection > 3)
+            antDirection -= 4;
+
+        //Advance the color of the ant's square by one
+        oldState = state[antX][antY];
+        (state[antX][antY])++;
+
+        //Make sure that the square is still within its range.  I.e. if it has reached a value equal to the state count, reset to zero.
+        if (state[antX][antY] == settings->stateCount)
+            state[antX][antY] = 0;
+
+        //Keep the zoomed-out view up to date, if it is in use
+        if (pyramid != 0)
+            pyramid->changeCell(antX, antY, oldState, state[antX][antY]);
+
+        //Record the change for the change blender, if it is listening
+        if (changeLogIndex != 0)
+            logChange(antX, antY);
+
+        //Grow the changed area if the ant is outside of it
+        if (antX < changedLeft)
+            changedLeft = antX;
+        if (antX > changedRight)
+            changedRight = antX;
+        if (antY < changedTop)
+            changedTop = antY;
+        if (antY > changedBottom)
+            changedBottom = antY;
+
+        //If the option to draw after each step is on, redraw the current square to its new color
+        if (drawSquareAfterEachStep)
+        {
+            //Determine the coordinates of the square in display terms (i.e. without the buffer)
+            displayX = antX - settings->gridBuffer;
+            displayY = antY - settings->gridBuffer;
+
+            //It is not necessary to check here to see if the displayX and displayY variables are within a proper range - the Grid class
+            //does that check in the drawSquare function.
+            displayGrid->drawSquare(displayX, displayY, stateArray[ state[antX][antY] ].color);
+        }
+
+        //Move the ant forward one square
+        switch (antDirection)
+        {
+        case 0: //ant is facing up
+            antX--;
+            break;
+        case 1: //ant is facing right
+            antY--; //seems backwards to me, but makes the correct pattern
+            break;
+        case 2: //ant is facing down
+            antX++;
+            break;
+        case 3: //ant is facing left
+            antY++; //seems backwards to me, but makes the correct pattern
+            break;
+        }
+
+        //If the option to draw the ant is on, as well as the option to draw after each step, draw the ant now
+        if ( (settings->showAntColor)&&(drawSquareAfterEachStep) )
+        {
+            //Determine the coordinates of the square in display terms (i.e. without the buffer)
+            displayX = antX - settings->gridBuffer;
+            displayY = antY - settings->gridBuffer;
+
+            //It is not necessary to check here to see if the displayX and displayY variables are within a proper range - the Grid class
+            //does that check in the drawSquare function.
+            displayGrid->drawSquare(displayX, displayY, settings->antColor);
+        }
+
+        //Check to see if the ant has moved out of range.
+        if ( (antX<0)||(antY<0)||(antX==columnCount)||(antY==rowCount) )
+        {
+            outOfRange = true;
+            break;
+        }
+
+    }
+}
+
+
+
+
+
+//Since the stateArray pointer will change when the user alters the number of states (the array is actually
+//deleted and recreated), it is necessary to have this function so the new pointer can be given to the AntGrid
+//object.
+void AntGrid::updateStateArrayPointer(StateRule * stateArrayP)
+{
+    stateArray = stateArrayP;
+}
+
+
+
+
+
+//This function draws only the square that the ant is on.
+void AntGrid::drawAntSquare()
+{
+    //Determine the coordinates of the square in display terms (i.e. without the buffer)
+    int displayX = antX - settings->gridBuffer;
+    int displayY = antY - settings->gridBuffer;
+
+    //It is not necessary to check here to see if the displayX and displayY variables are within a proper range - the Grid class
+    //does that check in the drawSquare function.
+
+    if (settings->showAntColor)
+        displayGrid->drawSquare(displayX, displayY, settings->antColor); //Draw the ant's color
+    else
+        displayGrid->drawSquare(displayX, displayY, stateArray[ state[antX][antY] ].color); //Draw the square's state color
+}
+
+
+
+
+
+//This function redraws every visible square in its state's color.  The drawing is split between the worker threads.
+void AntGrid::drawAllSquares()
+{
+    displayGrid->drawStates(state, settings->gridBuffer, statePalette());
+}
+
+
+
+
+
+//This function returns the color of each state
+QVector<QRgb> AntGrid::statePalette()
+{
+    QVector<QRgb> palette(settings->stateCount);
+    for (int i = 0; i < settings->stateCount; i++)
+        palette[i] = stateArray[i].color.rgb();
+    return palette;
+}
+
+StateRule * AntGrid::getStateArray()
+{
+    return stateArray;
+}
+
+//This function says whether a cell (in display terms) is part of the state array, including the buffer
+bool AntGrid::isInGrid(int column, int row)
+{
+    column += settings->gridBuffer;
+    row += settings->gridBuffer;
+    return ( (column >= 0)&&(row >= 0)&&(column < columnCount)&&(row < rowCount) );
+}
+
+
+
+
+
+//This function draws the states into a grid other than the display grid, such as one for another output of a
+//render.  firstColumn and firstRow are the cell (in display terms) at the target's top-left corner, and the states
+//are colored from palette.  Anything outside of the state array is drawn in the state 0 color.
+void AntGrid::drawStateArea(Grid * target, int firstColumn, int firstRow, const QVector<QRgb> & palette)
+{
+    target->drawStates(state, firstColumn + settings->gridBuffer, firstRow + settings->gridBuffer, columnCount, rowCount, palette);
+}
+
+
+
+
+
+//This function makes an 8-bit indexed copy of the grid image from the state array, with one color per state plus one
+//for the ant.  Saved as a palette PNG, this is a fraction of the size of the full color image and quicker to encode.
+//The counter and rules can't be drawn this way, so if either is showing a null image is returned instead.
+QImage AntGrid::makeIndexedImage()
+{
+    if ( (settings->showCounter)||(settings->showRules)||(settings->stateCount > 255) )
+        return QImage();
+
+    QVector<QRgb> palette = statePalette();
+    palette.append(settings->antColor.rgb());
+
+    QImage image(displayGrid->gridImage->size(), QImage::Format_Indexed8);
+    image.setColorTable(palette);
+    displayGrid->drawStatesIndexed(state, settings->gridBuffer, &image);
+
+    if (settings->showAntColor)
+        displayGrid->drawIndexedSquare(&image, antX - settings->gridBuffer, antY - settings->gridBuffer, settings->stateCount);
+
+    return image;
+}
+
+
+
+
+
+//This function saves the whole grid, including the buffer, as one PNG or TIFF image with posterCellSize pixels per
+//cell.  The image is drawn straight from the states and written a band of rows at a time, so it can be far bigger
+//than would fit in memory.  Like makeIndexedImage, it is indexed unless there are too many states.  compressionLevel
+//is a zlib level.
+bool AntGrid::writePoster(const QString & fileName, int posterCellSize, int compressionLevel)
+{
+    qint64 posterWidth = qint64(columnCount) * posterCellSize;
+    qint64 posterHeight = qint64(rowCount) * posterCellSize;
+    if ( (posterCellSize < 1)||(posterWidth * 4 > 0x7FFFFFFFLL)||(posterHeight > 0x7FFFFFFFLL) )
+        return false;
+
+    QVector<QRgb> palette = statePalette();
+    palette.append(settings->antColor.rgb());
+    bool indexed = (palette.size() <= 256);
+
+    PosterWriter writer;
+    if (!writer.open(fileName, PosterWriter::formatForFileName(fileName), int(posterWidth), int(posterHeight),
+                     indexed ? palette : QVector<QRgb>(), compressionLevel))
+        return false;
+
+    //The band is reused for every group of rows
+    int bandRows = writer.rowsPerBand();
+    int bytesPerLine = int(posterWidth) * (indexed ? 1 : 4);
+    QByteArray band(bandRows * bytesPerLine, Qt::Uninitialized);
+    uchar * bandBits = reinterpret_cast<uchar *>(band.data());
+
+    int ** states = state;
+    int stateColumns = columnCount;
+    int cellSize = posterCellSize;
+    int antColumn = ( (settings->showAntColor)&&(!outOfRange) ) ? antX : -1;
+    int antRow = antY;
+    int antIndex = palette.size() - 1;
+    const QRgb * colors = palette.constData();
+
+    for (int firstPixelRow = 0; firstPixelRow < int(posterHeight); firstPixelRow += bandRows)
+    {
+        int bandRowCount = qMin(bandRows, int(posterHeight) - firstPixelRow);
+
+        WorkerPool::runInBands(bandRowCount, [=](int firstRow, int lastRow)
+        {
+            for (int y = firstRow; y <= lastRow; y++)
+            {
+                int row = (firstPixelRow + y) / cellSize;
+                uchar * line = bandBits + y * bytesPerLine;
+                for (int column = 0; column < stateColumns; column++)
+                {
+                    int index = states[column][row];
+                    if ( (column == antColumn)&&(row == antRow) )
+                        index = antIndex;
+
+                    if (indexed)
+                        memset(line + column * cellSize, index, cellSize);
+                    else
+                    {
+                        QRgb * pixels = reinterpret_cast<QRgb *>(line) + column * cellSize;
+                        for (int x = 0; x < cellSize; x++)
+                            pixels[x] = colors[index];
+                    }
+                }
+            }
+        });
+
+        if (!writer.writeRows(bandBits, bandRowCount, bytesPerLine))
+        {
+            writer.close();
+            return false;
+        }
+    }
+
+    return writer.close();
+}
+
+
+
+
+
+//This function writes everything needed to carry on from the ant's current position: the ant itself, the changed
+//area and the states inside it.  Everything outside the changed area is state 0, so it isn't stored.  The states
+//are packed one byte each (two with more than 256 states) and compressed.
+void AntGrid::writeCheckpoint(QDataStream & stream)
+{
+    bool wideStates = (settings->stateCount > 256);
+    int areaWidth = changedRight - changedLeft + 1;
+    int areaHeight = changedBottom - changedTop + 1;
+
+    QByteArray packed(areaWidth * areaHeight * (wideStates ? 2 : 1), 0);
+    uchar * output = reinterpret_cast<uchar *>(packed.data());
+    for (int i = changedLeft; i <= changedRight; i++)
+    {
+        for (int j = changedTop; j <= changedBottom; j++)
+        {
+            *output++ = uchar(state[i][j]);
+            if (wideStates)
+                *output++ = uchar(state[i][j] >> 8);
+        }
+    }
+
+    stream << qint32(columnCount) << qint32(rowCount) << qint32(settings->stateCount);
+    stream << qint32(antX) << qint32(antY) << qint32(antDirection) << quint8(outOfRange ? 1 : 0);
+    stream << qint32(changedLeft) << qint32(changedTop) << qint32(changedRight) << qint32(changedBottom);
+    stream << qCompress(packed);
+}
+
+
+
+
+
+//This function restores what writeCheckpoint saved and redraws the grid image to match.  It returns false, leaving
+//the grid reset, if the checkpoint doesn't fit this grid (i.e. it was made with different settings).
+bool AntGrid::readCheckpoint(QDataStream & stream)
+{
+    qint32 columns, rows, states, x, y, direction, left, top, right, bottom;
+    quint8 outOfRangeFlag;
+    QByteArray compressed;
+    stream >> columns >> rows >> states;
+    stream >> x >> y >> direction >> outOfRangeFlag;
+    stream >> left >> top >> right >> bottom;
+    stream >> compressed;
+
+    resetGrid();
+
+    if ( (stream.status() != QDataStream::Ok)||(columns != columnCount)||(rows != rowCount)||(states != settings->stateCount) )
+        return false;
+    if ( (left < 0)||(top < 0)||(right >= columnCount)||(bottom >= rowCount)||(left > right)||(top > bottom) )
+        return false;
+
+    bool wideStates = (settings->stateCount > 256);
+    int areaWidth = right - left + 1;
+    int areaHeight = bottom - top + 1;
+    QByteArray packed = qUncompress(compressed);
+    if (packed.size() != areaWidth * areaHeight * (wideStates ? 2 : 1))
+        return false;
+
+    const uchar * input = reinterpret_cast<const uchar *>(packed.constData());
+    for (int i = left; i <= right; i++)
+    {
+        for (int j = top; j <= bottom; j++)
+        {
+            int cellState = *input++;
+            if (wideStates)
+                cellState |= (*input++) << 8;
+            state[i][j] = cellState;
+        }
+    }
+
+    antX = x;
+    antY = y;
+    antDirection = direction;
+    outOfRange = (outOfRangeFlag != 0);
+    changedLeft = left;
+    changedTop = top;
+    changedRight = right;
+    changedBottom = bottom;
+
+    if (pyramid != 0)
+        pyramid->rebuild(settings->stateCount);
+
+    //The ant square is drawn as it would have been after its last step.  Once it is out of range it isn't drawn.
+    drawAllSquares();
+    if (!outOfRange)
+        drawAntSquare();
+
+    return true;
+}
+
+
+
+
+
+//This function turns the zoomed-out summary of the grid on or off.  It needs to be on for renderWholeGrid to work.
+void AntGrid::setPyramidEnabled(bool enabled)
+{
+    if ( (enabled)&&(pyramid == 0) )
+        pyramid = new GridPyramid(state, columnCount, rowCount, settings->stateCount);
+
+    if ( (!enabled)&&(pyramid != 0) )
+    {
+        delete pyramid;
+        pyramid = 0;
+    }
+}
+
+bool AntGrid::pyramidEnabled()
+{
+    return (pyramid != 0);
+}
+
+
+
+
+
+//This function draws the entire grid, including the buffer that is normally hidden, scaled to fit the target image.
+//When the grid is larger than the image, several cells share each pixel and their colors are averaged.
+void AntGrid::renderWholeGrid(QImage * target)
+{
+    if (pyramid == 0)
+        return;
+
+    //Fit the whole grid into the image, centered
+    double cellsPerPixel = qMax(double(columnCount) / target->width(), double(rowCount) / target->height());
+    double firstColumn = (columnCount - cellsPerPixel * target->width()) / 2.0;
+    double firstRow = (rowCount - cellsPerPixel * target->height()) / 2.0;
+
+    renderView(target, firstColumn - settings->gridBuffer, firstRow - settings->gridBuffer, cellsPerPixel);
+}
+
+
+
+
+
+//This function draws any part of the grid, including the buffer, into the target image.  firstColumn and firstRow are
+//the cell (in display terms, and not necessarily a whole one) at the image's top-left corner, and cellsPerPixel is
+//the zoom.  The ant is drawn over the pixels its cell covers, which is a single pixel once it is too small to see
+//otherwise.
+void AntGrid::renderView(QImage * target, double firstColumn, double firstRow, double cellsPerPixel)
+{
+    if (pyramid == 0)
+        return;
+
+    firstColumn += settings->gridBuffer;
+    firstRow += settings->gridBuffer;
+    pyramid->render(target, firstColumn, firstRow, cellsPerPixel, statePalette());
+
+    if ( (settings->showAntColor)&&(!outOfRange) )
+    {
+        int left = int(floor((antX - firstColumn) / cellsPerPixel));
+        int top = int(floor((antY - firstRow) / cellsPerPixel));
+        int right = qMax(left, int(ceil((antX + 1 - firstColumn) / cellsPerPixel)) - 1);
+        int bottom = qMax(top, int(ceil((antY + 1 - firstRow) / cellsPerPixel)) - 1);
+
+        QRect antRect = QRect(QPoint(left, top), QPoint(right, bottom)) & target->rect();
+        for (int y = antRect.top(); y <= antRect.bottom(); y++)
+        {
+            for (int x = antRect.left(); x <= antRect.right(); x++)
+                target->setPixel(x, y, settings->antColor.rgb());
+        }
+    }
+}
+
+
+
+
+
+//This function returns the smallest rectangle (in display terms) holding every cell the ant has changed, and so every
+//cell that isn't in state 0.  It is kept up to date as the ant moves, so it costs nothing to ask for.
+QRect AntGrid::contentBounds()
+{
+    return QRect(QPoint(changedLeft - settings->gridBuffer, changedTop - settings->gridBuffer),
+                 QPoint(changedRight - settings->gridBuffer, changedBottom - settings->gridBuffer));
+}
+
+
+
+
+
+//This function turns the change log on or off.  While it is on, moveAnt lists the cells it changes in changeLog.
+//Only cells inside area (in display terms) are listed.  If no area is given, it is the visible part of the grid.
+void AntGrid::setChangeLogEnabled(bool enabled, QRect area)
+{
+    delete [] changeLogIndex;
+    changeLogIndex = 0;
+
+    if (enabled)
+    {
+        if (area.isNull())
+            area = QRect(0, 0, displayGrid->columnCount, displayGrid->rowCount);
+        changeLogArea = area & QRect(-settings->gridBuffer, -settings->gridBuffer, columnCount, rowCount);
+
+        int cellCount = changeLogArea.width() * changeLogArea.height();
+        changeLogIndex = new int [qMax(1, cellCount)];
+        for (int i = 0; i < cellCount; i++)
+            changeLogIndex[i] = -1;
+    }
+
+    changeLog.clear();
+    changeLogSample = 0;
+    changeLogSampleStart = 0;
+}
+
+
+
+
+
+//This function is called before moving the ant for each sample, so changes are labeled with the right sample.  At
+//sample zero, the log is emptied for the new frame.
+void AntGrid::startChangeLogSample(int sample)
+{
+    if (sample == 0)
+        changeLog.clear();
+
+    changeLogSample = sample;
+    changeLogSampleStart = changeLog.size();
+}
+
+
+
+
+
+void AntGrid::logChange(int column, int row)
+{
+    int displayX = column - settings->gridBuffer;
+    int displayY = row - settings->gridBuffer;
+
+    //Cells outside of the area can't be seen, so they don't matter to the images
+    if (!changeLogArea.contains(displayX, displayY))
+        return;
+
+    //If the cell already has an entry for this sample, just update its state.  The index may be left over from an
+    //earlier frame, after the log was cleared, so it has to be checked against the log itself.
+    int & index = changeLogIndex[(displayX - changeLogArea.left()) * changeLogArea.height() + (displayY - changeLogArea.top())];
+    if ( (index >= changeLogSampleStart)&&(index < changeLog.size())
+         &&(changeLog[index].column == displayX)&&(changeLog[index].row == displayY) )
+    {
+        changeLog[index].state = state[column][row];
+        return;
+    }
+
+    CellChange change;
+    change.column = displayX;
+    change.row = displayY;
+    change.sample = changeLogSample;
+    change.state = state[column][row];
+
+    index = changeLog.size();
+    changeLog.append(change);
+}
+
+
+
+
+
+//This function turns the path trace on or off.  While it is on, moveAnt adds each step to pathTrace.
+void AntGrid::setPathTraceEnabled(bool enabled)
+{
+    tracingPath = enabled;
+    if (enabled)
+        pathTrace.clear();
+}
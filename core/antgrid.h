@@ -0,0 +1,115 @@
+#ifndef ANTGRID_H
+#define ANTGRID_H
+
+#include "antdirection.h"
+#include "grid.h"
+#include "antsettings.h"
+#include "staterule.h"
+#include "gridpyramid.h"
+
+//One entry in AntGrid's change log: a visible cell that changed during a sample, and the state it was left in at the
+//end of that sample.  The column and row are in display terms (i.e. without the buffer).
+struct CellChange
+{
+    int column;
+    int row;
+    int sample;
+    int state;
+};
+
+//One entry in AntGrid's path trace: where the ant was at the start of a step (in AntGrid terms), which way it was
+//facing and the state of the cell it was on.
+struct AntStep
+{
+    int x;
+    int y;
+    int direction;
+    int state;
+};
+
+class AntGrid
+{
+public:
+    AntGrid(Grid * displayGridP, AntSettings * settingsP, StateRule * stateArrayP);
+    ~AntGrid();
+
+    //Functions
+    void resetGrid();
+    void resizeGrid();
+    int getState(int column, int row);
+    void moveAnt(int numberOfSteps, bool drawSquareAfterEachStep);
+    void moveAntWithoutDrawing(int numberOfSteps);
+    void updateStateArrayPointer(StateRule * stateArrayP);
+    void drawAntSquare();
+    void drawAllSquares();
+    void setPyramidEnabled(bool enabled);
+    bool pyramidEnabled();
+    void renderWholeGrid(QImage * target);
+    void renderView(QImage * target, double firstColumn, double firstRow, double cellsPerPixel);
+    QRect contentBounds();
+    QImage makeIndexedImage();
+    bool writePoster(const QString & fileName, int posterCellSize, int compressionLevel);
+    void setChangeLogEnabled(bool enabled, QRect area = QRect());
+    void startChangeLogSample(int sample);
+    void setPathTraceEnabled(bool enabled);
+    QVector<QRgb> statePalette();
+    StateRule * getStateArray();
+    bool isInGrid(int column, int row);
+    void drawStateArea(Grid * target, int firstColumn, int firstRow, const QVector<QRgb> & palette);
+    void writeCheckpoint(QDataStream & stream);
+    bool readCheckpoint(QDataStream & stream);
+
+    //Data members
+    int antX, antY;
+    int antDirection;
+    bool outOfRange;
+
+    //This is the main value in the class - it holds the current state of each square.
+    int ** state; //pointer to a pointer for a dynamic 2D array
+
+    //When the change log is enabled, every cell the ant changes inside the logged area (normally the visible part of
+    //the grid) is listed here, once per sample.  It is cleared when sample zero is started.
+    QVector<CellChange> changeLog;
+
+    //When the path trace is enabled, every step the ant takes is added here.  It is cleared when the trace is enabled.
+    QVector<AntStep> pathTrace;
+
+
+
+
+
+private:
+    int columnCount;
+    int rowCount;
+
+    int startingColumn;
+    int startingRow;
+
+    //The smallest rectangle (in AntGrid terms) holding every cell the ant has changed since the grid was reset.  The
+    //grid starts out all state 0, so every cell that isn't is inside it.
+    int changedLeft, changedTop, changedRight, changedBottom;
+
+    Grid * displayGrid;
+    AntSettings * settings;
+    StateRule * stateArray;
+
+    //The zoomed-out summary of the state array.  This is only made when the whole grid is being viewed, as keeping
+    //it up to date slows the ant down a little.
+    GridPyramid * pyramid;
+
+    //For each cell in the logged area, the index of its latest entry in the change log (or -1), so a cell that changes
+    //many times in one sample only gets one entry.  Null when the log is off.  The area is in display terms.
+    int * changeLogIndex;
+    QRect changeLogArea;
+    int changeLogSample;
+    int changeLogSampleStart;
+    bool tracingPath;
+
+    void stepAnt(int numberOfSteps, bool drawSquareAfterEachStep);
+    void logChange(int column, int row);
+    void calculateGridSize();
+    void calculateStart();
+
+};
+
+#endif // ANTGRID_H
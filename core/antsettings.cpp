@@ -1,276 +1,355 @@
-#include "antsettings.h"
-
-//default constructor - sets data members to default values
-AntSettings::AntSettings()
-{
-    stateCount = 2;
-    firstRandom = 1;
-    lastRandom = 2;
-    pixelWidth = 1280;
-    pixelHeight = 720;
-    cellSize = 5;
-    gridBuffer = 200;
-    startingDirection = 0; //up
-    startingColumn = 128;
-    startingRow = 72;
-    showCounter = true;
-    counterLocation = 3;
-    showRules = false;
-    rulesLocation = 0;
-    showAntColor = true;
-    antColor = QColor(255, 0, 0);
-    stepsPerUpdate = 1;
-    delayPerUpdate = 0;
-    stepsPerSample = 10;
-    samplesPerFrame = 100;
-    frameCount = 300;
-    saveZeroFrame = true;
-    searchSteps = 1000000;
-    includeBack = false;
-
-    QFont loadFont;
-    loadFont.fromString("Consolas,26,-1,5,50,0,0,0,0,0");
-    counterFont = loadFont;
-
-    time = 0;
-
-}
-
-
-
-
-
-//This function saves all settings to a file, both the ones stored in the AntSettings object and the
-//ones in the stateArray array.  I have no need to alter the contents of the stateArray array, so I
-//can just use the normal pointer approach that allows me to access an array.  This differs from the
-//loadFromFile function below where I do need to change the array's contents and therefore need to
-//use a pointer to a pointer.
-void AntSettings::saveToFile(QString fileName, StateWidget * stateArray)
-{
-    //Create the file object using the name and path provided by the user
-    QFile saveFile(fileName);
-
-    //Try to open the file
-    if (saveFile.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        //If opening was successful...
-
-        //Create an output stream object
-        QTextStream outputStream(&saveFile);
-
-        //Define a delimiter
-        QString delimiter = "=";
-
-        //Output all of the settings to the file!
-
-        //These settings are from the settings docking widget (everything but colors and directions of states)
-        //format: setting name=setting value
-        //example: number of states=2
-        outputStream << "number of states" << delimiter << stateCount << Qt::endl;
-        outputStream << "first state to randomize" << delimiter << firstRandom << Qt::endl;
-        outputStream << "last state to randomize" << delimiter << lastRandom << Qt::endl;
-        outputStream << "pixel width" << delimiter << pixelWidth << Qt::endl;
-        outputStream << "pixel height" << delimiter << pixelHeight << Qt::endl;
-        outputStream << "cell size" << delimiter << cellSize << Qt::endl;
-        outputStream << "grid buffer" << delimiter << gridBuffer << Qt::endl;
-        outputStream << "starting direction" << delimiter << startingDirection << Qt::endl;
-        outputStream << "starting column" << delimiter << startingColumn << Qt::endl;
-        outputStream << "starting row" << delimiter << startingRow << Qt::endl;
-        outputStream << "show counter" << delimiter << showCounter << Qt::endl;
-        outputStream << "counter location" << delimiter << counterLocation << Qt::endl;
-        outputStream << "show rules" << delimiter << showRules << Qt::endl;
-        outputStream << "rules location" << delimiter << rulesLocation << Qt::endl;
-        outputStream << "counter font" << delimiter << counterFont.toString() << Qt::endl;
-        outputStream << "show ant color" << delimiter << showAntColor << Qt::endl;
-        outputStream << "ant color" << delimiter << antColor.red() << "," << antColor.green() << "," << antColor.blue() << Qt::endl;
-        outputStream << "steps per update" << delimiter << stepsPerUpdate << Qt::endl;
-        outputStream << "delay per update" << delimiter << delayPerUpdate << Qt::endl;
-        outputStream << "steps per sample" << delimiter << stepsPerSample << Qt::endl;
-        outputStream << "samples per frame" << delimiter << samplesPerFrame << Qt::endl;
-        outputStream << "frame count" << delimiter << frameCount << Qt::endl;
-        outputStream << "save zero frame" << delimiter << saveZeroFrame << Qt::endl;
-        outputStream << "search step count" << delimiter << searchSteps << Qt::endl;
-        outputStream << "include back" << delimiter << includeBack << Qt::endl;
-
-        //This code stores the values in the state widgets
-        //format: stateNumber=direction=red,green,blue
-        //example: 1=right=255,127,220
-        for (int i=0; i<stateCount; i++)
-        {
-            //output the state number
-            //This uses the displayed number (starts at 1), not the array index (starts at 0)
-            outputStream << i+1 << delimiter;
-
-            //output the state direction
-            if (stateArray[i].direction == antRight)
-                outputStream << "right" << delimiter;
-            if (stateArray[i].direction == antLeft)
-                outputStream << "left" << delimiter;
-            if (stateArray[i].direction == antBack)
-                outputStream << "back" << delimiter;
-
-            //output the state color
-            outputStream << stateArray[i].color.red() << ",";
-            outputStream << stateArray[i].color.green() << ",";
-            outputStream << stateArray[i].color.blue() << Qt::endl;
-        }
-
-
-    }
-
-    //The QFile destructor will close the file automatically
-}
-
-
-
-
-
-//This function loads settings from a passed file.  It also needs to access the stateArray so it can
-//load values into the states.  See the loadOneSetting definition for why it has to be a pointer to
-//a pointer.
-void AntSettings::loadFromFile(QString fileName, StateWidget ** stateArrayPointer)
-{
-
-    //Open the file
-    QFile loadFile(fileName);
-
-    //If the file can't be opened, quit
-    if (!loadFile.open(QIODevice::ReadOnly | QIODevice::Text))
-        return;
-
-    //Create the input stream and a QString to hold the lines
-    QTextStream inputStream(&loadFile);
-    QString settingLine;
-
-    //Loop through each line in the file and call a function to save the settings
-    while (!inputStream.atEnd())
-    {
-        settingLine = inputStream.readLine();
-        loadOneSetting(&settingLine, stateArrayPointer);
-    }
-
-}
-
-
-
-
-
-//This function interprets a single line of a settings file and makes the appropriate changes to
-//either one of the members of the AntSettings object or to StateWidget stored in stateArray.
-//I need to pass stateArray as a pointer to a pointer.  This is because an array's address is a
-//pointer, but since I am going to be deleting and recreating the stateArray array, I will need to
-//change that pointer.  So getting a pointer to a pointer allows this code to change the pointer
-//that indicates where the stateArray is stored.
-void AntSettings::loadOneSetting(QString * settingLine, StateWidget ** stateArrayPointer)
-{
-
-    //if the line has a single equals sign, it is a regular setting (not a state color or direction)
-    if ( settingLine->count('=') == 1 )
-    {
-        QString settingName = settingLine->section("=", 0, 0);
-        QString settingValue = settingLine->section("=", 1);
-
-        if (settingName == "number of states")
-        {
-            stateCount = settingValue.toInt();
-
-            //Delete the existing StateWidget array.
-            delete [] *stateArrayPointer;
-
-            //Recreate the StateWidget array to the loaded size
-            *stateArrayPointer = new StateWidget [stateCount];
-
-            //Initialise each StateWidget to some default value
-            for (int i=0; i<stateCount; i++)
-            {
-                (*stateArrayPointer)[i].initialize(i+1, antRight, qRgb(0, 0, 0));
-            }
-
-        }
-        if (settingName == "first state to randomize")
-            firstRandom = settingValue.toInt();
-        if (settingName == "last state to randomize")
-            lastRandom = settingValue.toInt();
-        if (settingName == "pixel width")
-            pixelWidth = settingValue.toInt();
-        if (settingName == "pixel height")
-            pixelHeight = settingValue.toInt();
-        if (settingName == "cell size")
-            cellSize = settingValue.toInt();
-        if (settingName == "grid buffer")
-            gridBuffer = settingValue.toInt();
-        if (settingName == "starting direction")
-            startingDirection = settingValue.toInt();
-        if (settingName == "starting column")
-            startingColumn = settingValue.toInt();
-        if (settingName == "starting row")
-            startingRow = settingValue.toInt();
-        if (settingName == "show counter")
-            showCounter = settingValue.toInt();
-        if (settingName == "counter location")
-            counterLocation = settingValue.toInt();
-        if (settingName == "show rules")
-            showRules = settingValue.toInt();
-        if (settingName == "rules location")
-            rulesLocation = settingValue.toInt();
-        if (settingName == "counter font")
-            counterFont.fromString(settingValue);
-        if (settingName == "show ant color")
-            showAntColor = settingValue.toInt();
-        if (settingName == "ant color")
-        {
-            QString redString = settingValue.section(",", 0, 0);
-            QString greenString = settingValue.section(",", 1, 1);
-            QString blueString = settingValue.section(",", 2, 2);
-            int red = redString.toInt();
-            int green = greenString.toInt();
-            int blue = blueString.toInt();
-            antColor = QColor(red, green, blue);
-        }
-        if (settingName == "steps per update")
-            stepsPerUpdate = settingValue.toInt();
-        if (settingName == "delay per update")
-            delayPerUpdate = settingValue.toInt();
-        if (settingName == "steps per sample")
-            stepsPerSample = settingValue.toInt();
-        if (settingName == "samples per frame")
-            samplesPerFrame = settingValue.toInt();
-        if (settingName == "frame count")
-            frameCount = settingValue.toInt();
-        if (settingName == "save zero frame")
-            saveZeroFrame = settingValue.toInt();
-        if (settingName == "search step count")
-            searchSteps = settingValue.toInt();
-        if (settingName == "include back")
-            includeBack = settingValue.toInt();
-    }
-
-    //if the line has two equals signs, it is a state setting
-    if ( settingLine->count('=') == 2 )
-    {
-        QString numberString = settingLine->section("=", 0, 0);
-        int number = numberString.toInt();
-
-        QString directionString = settingLine->section("=", 1, 1);
-        AntDirection direction;
-        if (directionString=="right")
-            direction = antRight;
-        if (directionString=="left")
-            direction = antLeft;
-        if (directionString=="back")
-            direction = antBack;
-
-        QString colorString = settingLine->section("=", 2, 2);
-        QString redString = colorString.section(",", 0, 0);
-        QString greenString = colorString.section(",", 1, 1);
-        QString blueString = colorString.section(",", 2, 2);
-        int red = redString.toInt();
-        int green = greenString.toInt();
-        int blue = blueString.toInt();
-
-        //initialise the state to these values
-        (*stateArrayPointer)[number-1].initialize(number, direction, QColor(red, green, blue));
-
-    }
-
-}
+#include "antsettings.h"
+
+//default constructor - sets data members to default values
+AntSettings::AntSettings()
+{
+    stateCount = 2;
+    firstRandom = 1;
+    lastRandom = 2;
+    pixelWidth = 1280;
+    pixelHeight = 720;
+    cellSize = 5;
+    gridBuffer = 200;
+    startingDirection = 0; //up
+    startingColumn = 128;
+    startingRow = 72;
+    showCounter = true;
+    counterLocation = 3;
+    showRules = false;
+    rulesLocation = 0;
+    showAntColor = true;
+    antColor = QColor(255, 0, 0);
+    stepsPerUpdate = 1;
+    delayPerUpdate = 0;
+    targetFpsPlayback = false;
+    targetFps = 60;
+    stepsPerSample = 10;
+    samplesPerFrame = 100;
+    frameCount = 300;
+    saveZeroFrame = true;
+    blendChangedCellsOnly = true;
+    outputFormat = 0;
+    pngCompression = 1;
+    paletteFrames = false;
+    followPattern = false;
+    searchSteps = 1000000;
+    includeBack = false;
+    searchCheckInterval = 50000;
+    searchMaxPeriod = 1000;
+    searchBoundedChecks = 10;
+    searchExits = QStringList() << "escaped";
+
+    QFont loadFont;
+    loadFont.fromString("Consolas,26,-1,5,50,0,0,0,0,0");
+    counterFont = loadFont;
+
+    time = 0;
+
+}
+
+
+
+
+
+//This function saves all settings to a file, both the ones stored in the AntSettings object and the
+//ones in the stateArray array.  I have no need to alter the contents of the stateArray array, so I
+//can just use the normal pointer approach that allows me to access an array.  This differs from the
+//loadFromFile function below where I do need to change the array's contents and therefore need to
+//use a pointer to a pointer.
+void AntSettings::saveToFile(QString fileName, StateRule * stateArray)
+{
+    //Create the file object using the name and path provided by the user
+    QFile saveFile(fileName);
+
+    //Try to open the file
+    if (saveFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        //If opening was successful...
+
+        //Create an output stream object
+        QTextStream outputStream(&saveFile);
+
+        //Define a delimiter
+        QString delimiter = "=";
+
+        //Output all of the settings to the file!
+
+        //These settings are from the settings docking widget (everything but colors and directions of states)
+        //format: setting name=setting value
+        //example: number of states=2
+        outputStream << "number of states" << delimiter << stateCount << Qt::endl;
+        outputStream << "first state to randomize" << delimiter << firstRandom << Qt::endl;
+        outputStream << "last state to randomize" << delimiter << lastRandom << Qt::endl;
+        outputStream << "pixel width" << delimiter << pixelWidth << Qt::endl;
+        outputStream << "pixel height" << delimiter << pixelHeight << Qt::endl;
+        outputStream << "cell size" << delimiter << cellSize << Qt::endl;
+        outputStream << "grid buffer" << delimiter << gridBuffer << Qt::endl;
+        outputStream << "starting direction" << delimiter << startingDirection << Qt::endl;
+        outputStream << "starting column" << delimiter << startingColumn << Qt::endl;
+        outputStream << "starting row" << delimiter << startingRow << Qt::endl;
+        outputStream << "show counter" << delimiter << showCounter << Qt::endl;
+        outputStream << "counter location" << delimiter << counterLocation << Qt::endl;
+        outputStream << "show rules" << delimiter << showRules << Qt::endl;
+        outputStream << "rules location" << delimiter << rulesLocation << Qt::endl;
+        outputStream << "counter font" << delimiter << counterFont.toString() << Qt::endl;
+        outputStream << "show ant color" << delimiter << showAntColor << Qt::endl;
+        outputStream << "ant color" << delimiter << antColor.red() << "," << antColor.green() << "," << antColor.blue() << Qt::endl;
+        outputStream << "steps per update" << delimiter << stepsPerUpdate << Qt::endl;
+        outputStream << "delay per update" << delimiter << delayPerUpdate << Qt::endl;
+        outputStream << "target fps playback" << delimiter << targetFpsPlayback << Qt::endl;
+        outputStream << "target fps" << delimiter << targetFps << Qt::endl;
+        outputStream << "steps per sample" << delimiter << stepsPerSample << Qt::endl;
+        outputStream << "samples per frame" << delimiter << samplesPerFrame << Qt::endl;
+        outputStream << "frame count" << delimiter << frameCount << Qt::endl;
+        outputStream << "save zero frame" << delimiter << saveZeroFrame << Qt::endl;
+        outputStream << "blend changed cells only" << delimiter << blendChangedCellsOnly << Qt::endl;
+        outputStream << "output format" << delimiter << outputFormat << Qt::endl;
+        outputStream << "png compression" << delimiter << pngCompression << Qt::endl;
+        outputStream << "palette frames" << delimiter << paletteFrames << Qt::endl;
+        outputStream << "follow pattern" << delimiter << followPattern << Qt::endl;
+        outputStream << "search step count" << delimiter << searchSteps << Qt::endl;
+        outputStream << "include back" << delimiter << includeBack << Qt::endl;
+        outputStream << "search check interval" << delimiter << searchCheckInterval << Qt::endl;
+        outputStream << "search max period" << delimiter << searchMaxPeriod << Qt::endl;
+        outputStream << "search bounded checks" << delimiter << searchBoundedChecks << Qt::endl;
+        outputStream << "search exits" << delimiter << searchExits.join(",") << Qt::endl;
+
+        //Each extra output is one line
+        //format: extra output=name,width,height,cellSize,firstColumn,firstRow,format,overlay,palette
+        //example: extra output=closeup,640,360,20,100,50,0,0,#ffffff #000000
+        for (int i=0; i<extraOutputs.size(); i++)
+        {
+            const RenderOutputSettings & output = extraOutputs[i];
+            outputStream << "extra output" << delimiter << output.name << "," << output.pixelWidth << ","
+                         << output.pixelHeight << "," << output.cellSize << "," << output.firstColumn << ","
+                         << output.firstRow << "," << output.outputFormat << "," << output.showOverlay << ",";
+            for (int j=0; j<output.palette.size(); j++)
+            {
+                if (j > 0)
+                    outputStream << " ";
+                outputStream << QColor(output.palette[j]).name();
+            }
+            outputStream << Qt::endl;
+        }
+
+        //This code stores the values in the state widgets
+        //format: stateNumber=direction=red,green,blue
+        //example: 1=right=255,127,220
+        for (int i=0; i<stateCount; i++)
+        {
+            //output the state number
+            //This uses the displayed number (starts at 1), not the array index (starts at 0)
+            outputStream << i+1 << delimiter;
+
+            //output the state direction
+            if (stateArray[i].direction == antRight)
+                outputStream << "right" << delimiter;
+            if (stateArray[i].direction == antLeft)
+                outputStream << "left" << delimiter;
+            if (stateArray[i].direction == antBack)
+                outputStream << "back" << delimiter;
+
+            //output the state color
+            outputStream << stateArray[i].color.red() << ",";
+            outputStream << stateArray[i].color.green() << ",";
+            outputStream << stateArray[i].color.blue() << Qt::endl;
+        }
+
+
+    }
+
+    //The QFile destructor will close the file automatically
+}
+
+
+
+
+
+//This function loads settings from a passed file.  It also needs to access the stateArray so it can
+//load values into the states.  See the loadOneSetting definition for why it has to be a pointer to
+//a pointer.
+void AntSettings::loadFromFile(QString fileName, StateRule ** stateArrayPointer)
+{
+
+    //Open the file
+    QFile loadFile(fileName);
+
+    //If the file can't be opened, quit
+    if (!loadFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    //Create the input stream and a QString to hold the lines
+    QTextStream inputStream(&loadFile);
+    QString settingLine;
+
+    //The extra outputs are added one line at a time, so the old ones have to go first
+    extraOutputs.clear();
+
+    //Loop through each line in the file and call a function to save the settings
+    while (!inputStream.atEnd())
+    {
+        settingLine = inputStream.readLine();
+        loadOneSetting(&settingLine, stateArrayPointer);
+    }
+
+}
+
+
+
+
+
+//This function interprets a single line of a settings file and makes the appropriate changes to
+//either one of the members of the AntSettings object or to a StateRule stored in stateArray.
+//I need to pass stateArray as a pointer to a pointer.  This is because an array's address is a
+//pointer, but since I am going to be deleting and recreating the stateArray array, I will need to
+//change that pointer.  So getting a pointer to a pointer allows this code to change the pointer
+//that indicates where the stateArray is stored.
+void AntSettings::loadOneSetting(QString * settingLine, StateRule ** stateArrayPointer)
+{
+
+    //if the line has a single equals sign, it is a regular setting (not a state color or direction)
+    if ( settingLine->count('=') == 1 )
+    {
+        QString settingName = settingLine->section("=", 0, 0);
+        QString settingValue = settingLine->section("=", 1);
+
+        if (settingName == "number of states")
+        {
+            stateCount = settingValue.toInt();
+
+            //Delete the existing StateRule array.
+            delete [] *stateArrayPointer;
+
+            //Recreate the StateRule array to the loaded size.  Each state starts out as a black right turn.
+            *stateArrayPointer = new StateRule [stateCount];
+
+        }
+        if (settingName == "first state to randomize")
+            firstRandom = settingValue.toInt();
+        if (settingName == "last state to randomize")
+            lastRandom = settingValue.toInt();
+        if (settingName == "pixel width")
+            pixelWidth = settingValue.toInt();
+        if (settingName == "pixel height")
+            pixelHeight = settingValue.toInt();
+        if (settingName == "cell size")
+            cellSize = settingValue.toInt();
+        if (settingName == "grid buffer")
+            gridBuffer = settingValue.toInt();
+        if (settingName == "starting direction")
+            startingDirection = settingValue.toInt();
+        if (settingName == "starting column")
+            startingColumn = settingValue.toInt();
+        if (settingName == "starting row")
+            startingRow = settingValue.toInt();
+        if (settingName == "show counter")
+            showCounter = settingValue.toInt();
+        if (settingName == "counter location")
+            counterLocation = settingValue.toInt();
+        if (settingName == "show rules")
+            showRules = settingValue.toInt();
+        if (settingName == "rules location")
+            rulesLocation = settingValue.toInt();
+        if (settingName == "counter font")
+            counterFont.fromString(settingValue);
+        if (settingName == "show ant color")
+            showAntColor = settingValue.toInt();
+        if (settingName == "ant color")
+        {
+            QString redString = settingValue.section(",", 0, 0);
+            QString greenString = settingValue.section(",", 1, 1);
+            QString blueString = settingValue.section(",", 2, 2);
+            int red = redString.toInt();
+            int green = greenString.toInt();
+            int blue = blueString.toInt();
+            antColor = QColor(red, green, blue);
+        }
+        if (settingName == "steps per update")
+            stepsPerUpdate = settingValue.toInt();
+        if (settingName == "delay per update")
+            delayPerUpdate = settingValue.toInt();
+        if (settingName == "target fps playback")
+            targetFpsPlayback = settingValue.toInt();
+        if (settingName == "target fps")
+            targetFps = settingValue.toInt();
+        if (settingName == "steps per sample")
+            stepsPerSample = settingValue.toInt();
+        if (settingName == "samples per frame")
+            samplesPerFrame = settingValue.toInt();
+        if (settingName == "frame count")
+            frameCount = settingValue.toInt();
+        if (settingName == "save zero frame")
+            saveZeroFrame = settingValue.toInt();
+        if (settingName == "blend changed cells only")
+            blendChangedCellsOnly = settingValue.toInt();
+        if (settingName == "output format")
+            outputFormat = settingValue.toInt();
+        if (settingName == "png compression")
+            pngCompression = settingValue.toInt();
+        if (settingName == "palette frames")
+            paletteFrames = settingValue.toInt();
+        if (settingName == "follow pattern")
+            followPattern = settingValue.toInt();
+        if (settingName == "search step count")
+            searchSteps = settingValue.toInt();
+        if (settingName == "include back")
+            includeBack = settingValue.toInt();
+        if (settingName == "search check interval")
+            searchCheckInterval = settingValue.toInt();
+        if (settingName == "search max period")
+            searchMaxPeriod = settingValue.toInt();
+        if (settingName == "search bounded checks")
+            searchBoundedChecks = settingValue.toInt();
+        if (settingName == "search exits")
+            searchExits = settingValue.split(",", Qt::SkipEmptyParts);
+        if (settingName == "extra output")
+        {
+            RenderOutputSettings output;
+            output.name = settingValue.section(",", 0, 0);
+            output.pixelWidth = settingValue.section(",", 1, 1).toInt();
+            output.pixelHeight = settingValue.section(",", 2, 2).toInt();
+            output.cellSize = settingValue.section(",", 3, 3).toInt();
+            output.firstColumn = settingValue.section(",", 4, 4).toInt();
+            output.firstRow = settingValue.section(",", 5, 5).toInt();
+            output.outputFormat = settingValue.section(",", 6, 6).toInt();
+            output.showOverlay = settingValue.section(",", 7, 7).toInt();
+
+            QStringList colorNames = settingValue.section(",", 8, 8).split(" ", Qt::SkipEmptyParts);
+            for (int i=0; i<colorNames.size(); i++)
+                output.palette.append(QColor(colorNames[i]).rgb());
+
+            //Outputs that couldn't be drawn are left out
+            if ( (!output.name.isEmpty())&&(output.pixelWidth > 0)&&(output.pixelHeight > 0)&&(output.cellSize > 0) )
+                extraOutputs.append(output);
+        }
+    }
+
+    //if the line has two equals signs, it is a state setting
+    if ( settingLine->count('=') == 2 )
+    {
+        QString numberString = settingLine->section("=", 0, 0);
+        int number = numberString.toInt();
+
+        QString directionString = settingLine->section("=", 1, 1);
+        AntDirection direction;
+        if (directionString=="right")
+            direction = antRight;
+        if (directionString=="left")
+            direction = antLeft;
+        if (directionString=="back")
+            direction = antBack;
+
+        QString colorString = settingLine->section("=", 2, 2);
+        QString redString = colorString.section(",", 0, 0);
+        QString greenString = colorString.section(",", 1, 1);
+        QString blueString = colorString.section(",", 2, 2);
+        int red = redString.toInt();
+        int green = greenString.toInt();
+        int blue = blueString.toInt();
+
+        //initialise the state to these values
+        (*stateArrayPointer)[number-1] = StateRule(direction, QColor(red, green, blue));
+
+    }
+
+}
@@ -0,0 +1,89 @@
+#ifndef ANTSETTINGS_H
+#define ANTSETTINGS_H
+
+#include <QtGui>
+#include "antdirection.h"
+#include "staterule.h"
+
+//An extra output for a render.  Each one is drawn from the same simulation as the main output, but with its own size,
+//cell size, part of the grid, colors and format.  firstColumn and firstRow are the cell (in display terms) at the
+//output's top-left corner.  An empty palette means the states' own colors are used.
+struct RenderOutputSettings
+{
+    QString name;
+    int pixelWidth;
+    int pixelHeight;
+    int cellSize;
+    int firstColumn;
+    int firstRow;
+    int outputFormat;
+    bool showOverlay;
+    QVector<QRgb> palette;
+};
+
+class AntSettings
+{
+
+public:
+    //Default constructor - sets things to default values
+    AntSettings();
+
+    //functions
+    void saveToFile(QString filename, StateRule * stateArray);
+    void loadFromFile(QString filename, StateRule ** stateArrayPointer);
+    void loadOneSetting(QString * settingLine, StateRule ** stateArrayPointer);
+
+    //The setting members are public to prevent having to use set/get functions.
+    int stateCount;
+    int firstRandom;
+    int lastRandom;
+    int pixelWidth;
+    int pixelHeight;
+    int cellSize;
+    int gridBuffer;
+    int startingDirection;
+    int startingColumn;
+    int startingRow;
+    bool showCounter;
+    int counterLocation;
+    bool showRules;
+    int rulesLocation;
+    QFont counterFont;
+    bool showAntColor;
+    QColor antColor;
+    int stepsPerUpdate;
+    int delayPerUpdate;
+    bool targetFpsPlayback;
+    int targetFps;
+    int stepsPerSample;
+    int samplesPerFrame;
+    int frameCount;
+    bool saveZeroFrame;
+    bool blendChangedCellsOnly;
+    int outputFormat;
+    int pngCompression;
+    bool paletteFrames;
+    bool followPattern;
+    int searchSteps;
+    bool includeBack;
+
+    //How the searches classify rules as they run (see RuleClassifier).  These are only set in settings files.  The
+    //ant is checked every searchCheckInterval steps (never if it is 0), for repeats of up to searchMaxPeriod steps,
+    //and a pattern that hasn't grown for searchBoundedChecks checks in a row is bounded.  searchExits lists the
+    //classes that end a rule's run as soon as they are found.
+    int searchCheckInterval;
+    int searchMaxPeriod;
+    int searchBoundedChecks;
+    QStringList searchExits;
+
+    //The extra render outputs.  These are only set in settings files; there is no widget for them.
+    QVector<RenderOutputSettings> extraOutputs;
+
+    //This setting, the time counter, is not saved and loaded like the rest of the settings.  It is
+    //part of this class so it can exist in just one place: MainWindow and AntGrid objects will both
+    //be able to view it.
+    int time;
+
+};
+
+#endif // ANTSETTINGS_H
@@ -0,0 +1,315 @@
+#include "antsimulation.h"
+#include <QFileInfo>
+#include <QDir>
+#include <QFile>
+#include <QDataStream>
+#include <cstring>
+
+#include "counterrandom.h"
+
+static const char checkpointMagic[8] = {'A', 'N', 'T', 'C', 'H', 'E', 'C', 'K'};
+static const quint32 checkpointVersion = 2;
+
+AntSimulation::AntSimulation()
+{
+    //The same two default states as the GUI, in case the settings file doesn't have any
+    stateRules = new StateRule [2];
+    stateRules[0] = StateRule(antRight, QColor(255, 255, 255));
+    stateRules[1] = StateRule(antLeft, QColor(0, 0, 0));
+
+    displayGrid = 0;
+    antGrid = 0;
+    antCounter = 0;
+}
+
+
+
+
+
+AntSimulation::~AntSimulation()
+{
+    delete antCounter;
+    delete antGrid;
+    delete displayGrid;
+    delete [] stateRules;
+}
+
+
+
+
+
+//This function loads a settings file saved by the GUI.  It returns false if the file can't be read.  It has to be
+//called before create.
+bool AntSimulation::loadSettings(const QString & fileName)
+{
+    if (!QFileInfo(fileName).isReadable())
+        return false;
+
+    settings.loadFromFile(fileName, &stateRules);
+    return true;
+}
+
+
+
+
+
+//This function makes the grids for the current settings
+void AntSimulation::create()
+{
+    delete antCounter;
+    delete antGrid;
+    delete displayGrid;
+
+    displayGrid = new Grid(settings.pixelWidth, settings.pixelHeight, settings.cellSize, stateRules[0].color);
+    antGrid = new AntGrid(displayGrid, &settings, stateRules);
+    antCounter = new AntCounter(displayGrid, &settings, stateRules);
+}
+
+
+
+
+
+//This function goes back to time 0, in the same way as MainWindow::resetToStart
+void AntSimulation::resetToStart()
+{
+    settings.time = 0;
+    antCounter->reset();
+    displayGrid->fillImage(stateRules[0].color);
+    if ( (settings.showCounter)||(settings.showRules) )
+        antCounter->paintCountAndRules();
+    antGrid->resetGrid();
+}
+
+
+
+
+
+//This function moves the ant on from the start of frame fromFrame to the start of frame toFrame, without blending
+//anything, so a render can carry on from toFrame.  The frames are numbered as in a render, so frame 1 starts at time 0.
+//Nothing is drawn while the ant moves, and the image is redrawn from the states at the end, so it ends up exactly as
+//it would have been.  If a camera is passed, it is moved once per frame as it is when the camera follows the pattern.
+//If abortFlag is passed, it is checked once per frame, and once it is set the function returns straight away, leaving
+//the simulation part way.
+void AntSimulation::skipFrames(int fromFrame, int toFrame, Camera * camera, const QAtomicInt * abortFlag)
+{
+    if (toFrame <= fromFrame)
+        return;
+
+    for (int frame = fromFrame; frame < toFrame; frame++)
+    {
+        if ( (abortFlag != 0)&&(*abortFlag) )
+            return;
+
+        if (camera != 0)
+            camera->follow(antGrid->contentBounds());
+
+        //The counter box only grows, so it has to see every count a render paints: one per sample
+        if ( (settings.showCounter)||(settings.showRules) )
+        {
+            for (int sample = 0; sample < settings.samplesPerFrame; sample++)
+            {
+                antGrid->moveAntWithoutDrawing(settings.stepsPerSample);
+                antCounter->paintCountAndRules();
+            }
+        }
+        else
+            antGrid->moveAntWithoutDrawing(settings.samplesPerFrame * settings.stepsPerSample);
+    }
+
+    redrawImage();
+}
+
+
+
+
+
+//This function puts the camera on the normal view, where a render that follows the pattern starts
+void AntSimulation::resetCamera(Camera * camera)
+{
+    camera->resetToGrid(displayGrid->gridImage->size(), settings.cellSize);
+}
+
+
+
+
+
+//This function saves a checkpoint for the start of frame frameNumber.  The camera may be null if it isn't being used.
+bool AntSimulation::saveCheckpoint(const QString & fileName, int frameNumber, Camera * camera)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    Camera unusedCamera;
+    if (camera == 0)
+        camera = &unusedCamera;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(checkpointMagic, 8);
+    stream << checkpointVersion << qint32(frameNumber) << qint32(settings.time) << checkpointKey();
+    antGrid->writeCheckpoint(stream);
+    antCounter->writeCheckpoint(stream);
+    camera->writeCheckpoint(stream);
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+
+
+
+//This function restores a checkpoint and returns the frame it is for, or -1 if it can't be read or was made with
+//different settings.  The camera may be null.  The simulation is only changed once the header has been checked.
+int AntSimulation::loadCheckpoint(const QString & fileName, Camera * camera)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    char magic[8];
+    quint32 version;
+    qint32 frameNumber, time;
+    quint64 key;
+    if (stream.readRawData(magic, 8) != 8)
+        return -1;
+    stream >> version >> frameNumber >> time >> key;
+    if ( (stream.status() != QDataStream::Ok)||(memcmp(magic, checkpointMagic, 8) != 0)||(version != checkpointVersion) )
+        return -1;
+
+    //Frame 1 starts at time 0, so the time has to be where these settings would have the frame start
+    qint64 frameTime = qint64(frameNumber - 1) * settings.samplesPerFrame * settings.stepsPerSample;
+    if ( (frameNumber < 1)||(time != frameTime)||(key != checkpointKey()) )
+        return -1;
+
+    settings.time = time;
+    if (!antGrid->readCheckpoint(stream))
+        return -1;
+    antCounter->readCheckpoint(stream);
+
+    Camera unusedCamera;
+    if (camera == 0)
+        camera = &unusedCamera;
+    camera->readCheckpoint(stream);
+    if (stream.status() != QDataStream::Ok)
+        return -1;
+
+    //The grid was drawn by readCheckpoint, but the counter and rules go on top
+    if ( (settings.showCounter)||(settings.showRules) )
+        antCounter->paintCountAndRules();
+
+    return frameNumber;
+}
+
+
+
+
+
+//This function gets the simulation to the start of frame frameNumber as quickly as it can: from the latest checkpoint
+//in directory that isn't past it, or from the start if there isn't one.  It returns the frame it started from.  The
+//replay stops early if abortFlag is set (see skipFrames).
+int AntSimulation::restoreFromCheckpoints(const QString & directory, int frameNumber, Camera * camera, const QAtomicInt * abortFlag)
+{
+    int bestFrame = 0;
+    QStringList fileNames = QDir(directory).entryList(QStringList() << "checkpoint*.antc", QDir::Files);
+    for (int i = 0; i < fileNames.size(); i++)
+    {
+        int checkpointFrame = fileNames[i].mid(10, fileNames[i].size() - 15).toInt();
+        if ( (checkpointFrame <= frameNumber)&&(checkpointFrame > bestFrame) )
+            bestFrame = checkpointFrame;
+    }
+
+    int startFrame = -1;
+    if (bestFrame > 0)
+        startFrame = loadCheckpoint(checkpointFileName(directory, bestFrame), camera);
+
+    if (startFrame < 1)
+    {
+        resetToStart();
+        if (camera != 0)
+            resetCamera(camera);
+        startFrame = 1;
+    }
+
+    skipFrames(startFrame, frameNumber, camera, abortFlag);
+    return startFrame;
+}
+
+
+
+
+
+//This function says whether every checkpoint in directory was made with the current settings, so that a render that
+//used them can carry on.  It is true if there aren't any.
+bool AntSimulation::checkpointsMatch(const QString & directory)
+{
+    QStringList fileNames = QDir(directory).entryList(QStringList() << "checkpoint*.antc", QDir::Files);
+    for (int i = 0; i < fileNames.size(); i++)
+    {
+        QFile file(directory + QDir::separator() + fileNames[i]);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+
+        QDataStream stream(&file);
+        stream.setByteOrder(QDataStream::LittleEndian);
+
+        char magic[8];
+        quint32 version;
+        qint32 frameNumber, time;
+        quint64 key;
+        if (stream.readRawData(magic, 8) != 8)
+            return false;
+        stream >> version >> frameNumber >> time >> key;
+        if ( (stream.status() != QDataStream::Ok)||(memcmp(magic, checkpointMagic, 8) != 0)||(version != checkpointVersion) )
+            return false;
+        if (key != checkpointKey())
+            return false;
+    }
+
+    return true;
+}
+
+
+
+
+
+//This function returns the settings key saved in checkpoints: a hash of the number of states, the way the ant turns
+//on each, where it starts and which way it faces, and how many steps each frame has.  The grid size is checked as the
+//grid is read.
+quint64 AntSimulation::checkpointKey()
+{
+    quint64 key = CounterRandom::hash(quint64(settings.stateCount), quint64(settings.samplesPerFrame),
+                                      quint64(settings.stepsPerSample));
+    key = CounterRandom::hash(key, quint64(quint32(settings.startingColumn)), quint64(quint32(settings.startingRow)));
+    key = CounterRandom::hash(key, quint64(settings.startingDirection), 0);
+    for (int i = 0; i < settings.stateCount; i++)
+        key = CounterRandom::hash(key, quint64(i), quint64(stateRules[i].direction));
+    return key;
+}
+
+
+
+
+
+QString AntSimulation::checkpointFileName(const QString & directory, int frameNumber)
+{
+    return directory + QDir::separator() + "checkpoint" + QString::number(frameNumber).rightJustified(5, '0') + ".antc";
+}
+
+
+
+
+
+//This function draws the grid image from the states, as it would be at the end of a sample: every square, then the
+//ant, then the counter and rules on top.
+void AntSimulation::redrawImage()
+{
+    antGrid->drawAllSquares();
+    if (!antGrid->outOfRange)
+        antGrid->drawAntSquare();
+    if ( (settings.showCounter)||(settings.showRules) )
+        antCounter->paintCountAndRules();
+}
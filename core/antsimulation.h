@@ -0,0 +1,51 @@
+#ifndef ANTSIMULATION_H
+#define ANTSIMULATION_H
+
+#include <QString>
+#include <QAtomicInt>
+
+#include "antsettings.h"
+#include "staterule.h"
+#include "grid.h"
+#include "antgrid.h"
+#include "antcounter.h"
+#include "camera.h"
+
+//This class holds one complete simulation without any GUI: the settings and rules, the grid image, the ant grid and the
+//counter.  MainWindow keeps these objects itself, but the command line tool and the render queue use this class so
+//they can each have their own.
+//
+//A render can be split between processes with checkpoints.  A checkpoint holds everything needed to start rendering at
+//a given frame: the time, the ant, the states it has changed, the size of the counter box and the camera.  It is
+//little endian: "ANTCHECK", version, frame number, time, settings key, then the grid, counter and camera in that order.
+//The settings key is a hash of the settings that decide where the ant goes (see checkpointKey), so a checkpoint made
+//with other rules or from another start isn't used.
+class AntSimulation
+{
+public:
+    AntSimulation();
+    ~AntSimulation();
+
+    bool loadSettings(const QString & fileName);
+    void create();
+    void resetToStart();
+    void skipFrames(int fromFrame, int toFrame, Camera * camera = 0, const QAtomicInt * abortFlag = 0);
+    void resetCamera(Camera * camera);
+    bool saveCheckpoint(const QString & fileName, int frameNumber, Camera * camera);
+    int loadCheckpoint(const QString & fileName, Camera * camera);
+    int restoreFromCheckpoints(const QString & directory, int frameNumber, Camera * camera, const QAtomicInt * abortFlag = 0);
+    bool checkpointsMatch(const QString & directory);
+    quint64 checkpointKey();
+    static QString checkpointFileName(const QString & directory, int frameNumber);
+
+    AntSettings settings;
+    StateRule * stateRules;
+    Grid * displayGrid;
+    AntGrid * antGrid;
+    AntCounter * antCounter;
+
+private:
+    void redrawImage();
+};
+
+#endif // ANTSIMULATION_H
@@ -0,0 +1,472 @@
+#include "blendkernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BLEND_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BLEND_TARGET_SSE2
+#define BLEND_TARGET_AVX2
+#else
+#define BLEND_TARGET_SSE2 __attribute__((target("sse2")))
+#define BLEND_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+//The kernels in use.  They are chosen once, the first time any of them is needed.
+static void (*addBytesKernel)(const uchar *, quint32 *, int) = 0;
+static void (*divideSumsKernel)(const quint32 *, uchar *, int, int) = 0;
+static void (*rgbToYuv420Kernel)(const uchar *, const uchar *, int, uchar *, uchar *, uchar *, uchar *) = 0;
+static BlendKernels::InstructionSet kernelInstructionSet = BlendKernels::scalarInstructions;
+
+
+
+
+
+//Dividing by the same number over and over can be done with a multiply and a shift, which (unlike division) the SIMD
+//instruction sets can do.  For a divisor d that isn't a power of two, with L = floor(log2(d)) and
+//m = ceil(2^(32+L) / d), (x * m) >> (32+L) equals x / d whenever x * (m * d - 2^(32+L)) < 2^(32+L), which holds for
+//every x below 2^31.  The numbers divided here are at most 511 * sampleCount.  Powers of two are just a shift.
+class Divider
+{
+public:
+    Divider(quint32 divisor)
+    {
+        shift = 0;
+        while ((quint32(2) << shift) <= divisor)
+            shift++;
+        powerOfTwo = ((divisor & (divisor - 1)) == 0);
+        if (powerOfTwo)
+            multiplier = 0;
+        else
+            multiplier = quint32(((quint64(1) << (32 + shift)) + divisor - 1) / divisor);
+    }
+
+    bool powerOfTwo;
+    int shift;
+    quint32 multiplier;
+};
+
+
+
+
+
+static void addBytesScalar(const uchar * bytes, quint32 * sums, int byteCount)
+{
+    for (int i = 0; i < byteCount; i++)
+        sums[i] += bytes[i];
+}
+
+static void divideSumsScalar(const quint32 * sums, uchar * bytes, int byteCount, int sampleCount)
+{
+    //(2 * sum + count) / (2 * count) is sum / count + 0.5, rounded down
+    quint32 doubleCount = 2 * sampleCount;
+    for (int i = 0; i < byteCount; i++)
+        bytes[i] = uchar((2 * sums[i] + sampleCount) / doubleCount);
+}
+
+
+
+
+
+//The color conversion uses the usual integer form of BT.601 with video levels (Y from 16 to 235), which is what x264
+//assumes for YUV4MPEG2 input.  Each U and V sample is made from the average of the 2x2 pixels it covers.
+static inline int lumaOf(quint32 pixel)
+{
+    int red = (pixel >> 16) & 0xff;
+    int green = (pixel >> 8) & 0xff;
+    int blue = pixel & 0xff;
+    return ((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16;
+}
+
+static void rgbToYuv420Scalar(const uchar * topRow, const uchar * bottomRow, int width, uchar * yTop, uchar * yBottom, uchar * u, uchar * v)
+{
+    const quint32 * top = reinterpret_cast<const quint32 *>(topRow);
+    const quint32 * bottom = reinterpret_cast<const quint32 *>(bottomRow);
+
+    for (int x = 0; x < width; x++)
+    {
+        yTop[x] = uchar(lumaOf(top[x]));
+        if (yBottom != 0)
+            yBottom[x] = uchar(lumaOf(bottom[x]));
+    }
+
+    //An odd last column is paired with itself
+    for (int chromaX = 0; chromaX < (width + 1) / 2; chromaX++)
+    {
+        int left = 2 * chromaX;
+        int right = qMin(left + 1, width - 1);
+        int averages[3];
+        for (int shift = 0, c = 0; c < 3; shift += 8, c++)
+            averages[c] = ( ((top[left] >> shift) & 0xff) + ((top[right] >> shift) & 0xff)
+                          + ((bottom[left] >> shift) & 0xff) + ((bottom[right] >> shift) & 0xff) + 2 ) >> 2;
+        int blue = averages[0], green = averages[1], red = averages[2];
+
+        u[chromaX] = uchar(((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+        v[chromaX] = uchar(((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+    }
+}
+
+
+
+
+
+#ifdef BLEND_KERNELS_X86
+
+BLEND_TARGET_SSE2 static void addBytesSse2(const uchar * bytes, quint32 * sums, int byteCount)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    //Widen 16 bytes at a time to 32 bits and add them to the totals
+    int i = 0;
+    for (; i + 16 <= byteCount; i += 16)
+    {
+        __m128i byteVector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+        __m128i low = _mm_unpacklo_epi8(byteVector, zero);
+        __m128i high = _mm_unpackhi_epi8(byteVector, zero);
+
+        __m128i * sumVectors = reinterpret_cast<__m128i *>(sums + i);
+        _mm_storeu_si128(sumVectors + 0, _mm_add_epi32(_mm_loadu_si128(sumVectors + 0), _mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_si128(sumVectors + 1, _mm_add_epi32(_mm_loadu_si128(sumVectors + 1), _mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_si128(sumVectors + 2, _mm_add_epi32(_mm_loadu_si128(sumVectors + 2), _mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_si128(sumVectors + 3, _mm_add_epi32(_mm_loadu_si128(sumVectors + 3), _mm_unpackhi_epi16(high, zero)));
+    }
+
+    //Finish off any leftover bytes
+    addBytesScalar(bytes + i, sums + i, byteCount - i);
+}
+
+BLEND_TARGET_SSE2 static inline __m128i divideSse2(__m128i numerators, const Divider & divider, __m128i multiplier, __m128i shift)
+{
+    if (divider.powerOfTwo)
+        return _mm_srl_epi32(numerators, shift);
+
+    //_mm_mul_epu32 only multiplies the even lanes, so do the odd lanes separately and then put the high halves of the
+    //products back together.
+    __m128i evenProducts = _mm_mul_epu32(numerators, multiplier);
+    __m128i oddProducts = _mm_mul_epu32(_mm_srli_epi64(numerators, 32), multiplier);
+    __m128i highHalves = _mm_or_si128(_mm_srli_epi64(evenProducts, 32),
+                                      _mm_and_si128(oddProducts, _mm_set_epi32(-1, 0, -1, 0)));
+    return _mm_srl_epi32(highHalves, shift);
+}
+
+BLEND_TARGET_SSE2 static void divideSumsSse2(const quint32 * sums, uchar * bytes, int byteCount, int sampleCount)
+{
+    Divider divider(2 * sampleCount);
+    const __m128i multiplier = _mm_set1_epi32(int(divider.multiplier));
+    const __m128i shift = _mm_cvtsi32_si128(divider.shift);
+    const __m128i half = _mm_set1_epi32(sampleCount);
+
+    //Divide 16 totals at a time and pack the results down to bytes.  The results are at most 255, so the saturating
+    //packs don't change them.
+    int i = 0;
+    for (; i + 16 <= byteCount; i += 16)
+    {
+        const __m128i * sumVectors = reinterpret_cast<const __m128i *>(sums + i);
+        __m128i quotients[4];
+        for (int j = 0; j < 4; j++)
+        {
+            __m128i sum = _mm_loadu_si128(sumVectors + j);
+            quotients[j] = divideSse2(_mm_add_epi32(_mm_add_epi32(sum, sum), half), divider, multiplier, shift);
+        }
+        __m128i words01 = _mm_packs_epi32(quotients[0], quotients[1]);
+        __m128i words23 = _mm_packs_epi32(quotients[2], quotients[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + i), _mm_packus_epi16(words01, words23));
+    }
+
+    divideSumsScalar(sums + i, bytes + i, byteCount - i, sampleCount);
+}
+
+
+
+
+
+BLEND_TARGET_AVX2 static void addBytesAvx2(const uchar * bytes, quint32 * sums, int byteCount)
+{
+    //Widen 32 bytes at a time to 32 bits and add them to the totals
+    int i = 0;
+    for (; i + 32 <= byteCount; i += 32)
+    {
+        __m256i * sumVectors = reinterpret_cast<__m256i *>(sums + i);
+        for (int j = 0; j < 4; j++)
+        {
+            __m256i widened = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(bytes + i + 8 * j)));
+            _mm256_storeu_si256(sumVectors + j, _mm256_add_epi32(_mm256_loadu_si256(sumVectors + j), widened));
+        }
+    }
+
+    addBytesScalar(bytes + i, sums + i, byteCount - i);
+}
+
+BLEND_TARGET_AVX2 static void divideSumsAvx2(const quint32 * sums, uchar * bytes, int byteCount, int sampleCount)
+{
+    Divider divider(2 * sampleCount);
+    const __m256i multiplier = _mm256_set1_epi32(int(divider.multiplier));
+    const __m128i shift = _mm_cvtsi32_si128(divider.shift);
+    const __m256i half = _mm256_set1_epi32(sampleCount);
+    const __m256i oddLanes = _mm256_set_epi32(-1, 0, -1, 0, -1, 0, -1, 0);
+
+    //The packs work within each 128-bit half, so this puts the groups of four bytes back in order afterwards
+    const __m256i byteOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int i = 0;
+    for (; i + 32 <= byteCount; i += 32)
+    {
+        const __m256i * sumVectors = reinterpret_cast<const __m256i *>(sums + i);
+        __m256i quotients[4];
+        for (int j = 0; j < 4; j++)
+        {
+            __m256i sum = _mm256_loadu_si256(sumVectors + j);
+            __m256i numerators = _mm256_add_epi32(_mm256_add_epi32(sum, sum), half);
+            if (divider.powerOfTwo)
+                quotients[j] = _mm256_srl_epi32(numerators, shift);
+            else
+            {
+                __m256i evenProducts = _mm256_mul_epu32(numerators, multiplier);
+                __m256i oddProducts = _mm256_mul_epu32(_mm256_srli_epi64(numerators, 32), multiplier);
+                __m256i highHalves = _mm256_or_si256(_mm256_srli_epi64(evenProducts, 32), _mm256_and_si256(oddProducts, oddLanes));
+                quotients[j] = _mm256_srl_epi32(highHalves, shift);
+            }
+        }
+        __m256i words01 = _mm256_packs_epi32(quotients[0], quotients[1]);
+        __m256i words23 = _mm256_packs_epi32(quotients[2], quotients[3]);
+        __m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words01, words23), byteOrder);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(bytes + i), packed);
+    }
+
+    divideSumsScalar(sums + i, bytes + i, byteCount - i, sampleCount);
+}
+
+//This function splits 8 RGB32 pixels into their blue, green and red values, as 16-bit numbers.
+BLEND_TARGET_SSE2 static inline void splitChannelsSse2(const uchar * pixels, __m128i & blue, __m128i & green, __m128i & red)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels));
+    __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pixels + 16));
+
+    blue = _mm_packs_epi32(_mm_and_si128(first, byteMask), _mm_and_si128(second, byteMask));
+    green = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(first, 8), byteMask), _mm_and_si128(_mm_srli_epi32(second, 8), byteMask));
+    red = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(first, 16), byteMask), _mm_and_si128(_mm_srli_epi32(second, 16), byteMask));
+}
+
+//The luma sum is at most 56,228, which fits in an unsigned 16-bit lane, so it can be shifted down without widening
+BLEND_TARGET_SSE2 static inline __m128i lumaSse2(__m128i blue, __m128i green, __m128i red)
+{
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(red, _mm_set1_epi16(66)), _mm_mullo_epi16(green, _mm_set1_epi16(129)));
+    sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_mullo_epi16(blue, _mm_set1_epi16(25)), _mm_set1_epi16(128)));
+    return _mm_add_epi16(_mm_srli_epi16(sum, 8), _mm_set1_epi16(16));
+}
+
+//This function averages one channel over 2x2 blocks: 8 pixels from each of two rows in, 4 averages out (as 32-bit)
+BLEND_TARGET_SSE2 static inline __m128i blockSumsSse2(__m128i top, __m128i bottom)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    return _mm_add_epi32(_mm_madd_epi16(top, ones), _mm_madd_epi16(bottom, ones));
+}
+
+BLEND_TARGET_SSE2 static inline __m128i blockAveragesSse2(__m128i firstSums, __m128i secondSums)
+{
+    __m128i sums = _mm_packs_epi32(firstSums, secondSums);
+    return _mm_srli_epi16(_mm_add_epi16(sums, _mm_set1_epi16(2)), 2);
+}
+
+BLEND_TARGET_SSE2 static inline __m128i chromaSse2(__m128i blue, __m128i green, __m128i red, short redFactor, short greenFactor, short blueFactor)
+{
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(red, _mm_set1_epi16(redFactor)), _mm_mullo_epi16(green, _mm_set1_epi16(greenFactor)));
+    sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_mullo_epi16(blue, _mm_set1_epi16(blueFactor)), _mm_set1_epi16(128)));
+    return _mm_add_epi16(_mm_srai_epi16(sum, 8), _mm_set1_epi16(128));
+}
+
+BLEND_TARGET_SSE2 static void rgbToYuv420Sse2(const uchar * topRow, const uchar * bottomRow, int width, uchar * yTop, uchar * yBottom, uchar * u, uchar * v)
+{
+    //16 pixels from each row at a time, giving 16 Y values per row and 8 each of U and V
+    int x = 0;
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i blue[4], green[4], red[4];
+        splitChannelsSse2(topRow + 4 * x, blue[0], green[0], red[0]);
+        splitChannelsSse2(topRow + 4 * x + 32, blue[1], green[1], red[1]);
+        splitChannelsSse2(bottomRow + 4 * x, blue[2], green[2], red[2]);
+        splitChannelsSse2(bottomRow + 4 * x + 32, blue[3], green[3], red[3]);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(yTop + x),
+                         _mm_packus_epi16(lumaSse2(blue[0], green[0], red[0]), lumaSse2(blue[1], green[1], red[1])));
+        if (yBottom != 0)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(yBottom + x),
+                             _mm_packus_epi16(lumaSse2(blue[2], green[2], red[2]), lumaSse2(blue[3], green[3], red[3])));
+
+        __m128i averageBlue = blockAveragesSse2(blockSumsSse2(blue[0], blue[2]), blockSumsSse2(blue[1], blue[3]));
+        __m128i averageGreen = blockAveragesSse2(blockSumsSse2(green[0], green[2]), blockSumsSse2(green[1], green[3]));
+        __m128i averageRed = blockAveragesSse2(blockSumsSse2(red[0], red[2]), blockSumsSse2(red[1], red[3]));
+
+        const __m128i zero = _mm_setzero_si128();
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2),
+                         _mm_packus_epi16(chromaSse2(averageBlue, averageGreen, averageRed, -38, -74, 112), zero));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2),
+                         _mm_packus_epi16(chromaSse2(averageBlue, averageGreen, averageRed, 112, -94, -18), zero));
+    }
+
+    if (x < width)
+        rgbToYuv420Scalar(topRow + 4 * x, bottomRow + 4 * x, width - x, yTop + x, (yBottom != 0) ? yBottom + x : 0, u + x / 2, v + x / 2);
+}
+
+#endif // BLEND_KERNELS_X86
+
+
+
+
+
+static void useInstructionSet(BlendKernels::InstructionSet instructionSet)
+{
+    kernelInstructionSet = instructionSet;
+    switch (instructionSet)
+    {
+#ifdef BLEND_KERNELS_X86
+    case BlendKernels::sse2Instructions:
+        addBytesKernel = addBytesSse2;
+        divideSumsKernel = divideSumsSse2;
+        rgbToYuv420Kernel = rgbToYuv420Sse2;
+        break;
+    case BlendKernels::avx2Instructions:
+        addBytesKernel = addBytesAvx2;
+        divideSumsKernel = divideSumsAvx2;
+        rgbToYuv420Kernel = rgbToYuv420Sse2; //the conversion is limited by memory, so there is no AVX2 version
+        break;
+#endif
+    default:
+        kernelInstructionSet = BlendKernels::scalarInstructions;
+        addBytesKernel = addBytesScalar;
+        divideSumsKernel = divideSumsScalar;
+        rgbToYuv420Kernel = rgbToYuv420Scalar;
+        break;
+    }
+}
+
+
+
+
+
+void BlendKernels::addBytes(const uchar * bytes, quint32 * sums, int byteCount)
+{
+    static const bool chosen = (chooseKernels(), true);
+    Q_UNUSED(chosen);
+    addBytesKernel(bytes, sums, byteCount);
+}
+
+
+
+
+
+void BlendKernels::divideSums(const quint32 * sums, uchar * bytes, int byteCount, int sampleCount)
+{
+    static const bool chosen = (chooseKernels(), true);
+    Q_UNUSED(chosen);
+
+    //The multiply-and-shift division is only proven for sample counts that keep 2 * sum + count within 32 bits
+    if (sampleCount > 4000000)
+        divideSumsScalar(sums, bytes, byteCount, sampleCount);
+    else
+        divideSumsKernel(sums, bytes, byteCount, sampleCount);
+}
+
+
+
+
+
+//This function converts a pair of RGB32 rows to YUV 4:2:0: a row of Y values for each, and one row each of U and V
+//at half the width (rounded up).  For an odd last row, pass the same row twice and a null yBottom.
+void BlendKernels::rgbToYuv420(const uchar * topRow, const uchar * bottomRow, int width, uchar * yTop, uchar * yBottom, uchar * u, uchar * v)
+{
+    static const bool chosen = (chooseKernels(), true);
+    Q_UNUSED(chosen);
+    rgbToYuv420Kernel(topRow, bottomRow, width, yTop, yBottom, u, v);
+}
+
+
+
+
+
+//This function asks the CPU which instruction sets it (and the operating system) supports.
+BlendKernels::InstructionSet BlendKernels::bestSupportedInstructionSet()
+{
+#if defined(BLEND_KERNELS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int highestLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    bool osSavesAvx = ((info[2] & (1 << 27)) != 0)&&((_xgetbv(0) & 6) == 6);
+    bool avx2 = false;
+    if ( (highestLeaf >= 7)&&(osSavesAvx) )
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    if (avx2)
+        return avx2Instructions;
+    if (sse2)
+        return sse2Instructions;
+#elif defined(BLEND_KERNELS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return avx2Instructions;
+    if (__builtin_cpu_supports("sse2"))
+        return sse2Instructions;
+#endif
+    return scalarInstructions;
+}
+
+
+
+
+
+BlendKernels::InstructionSet BlendKernels::currentInstructionSet()
+{
+    static const bool chosen = (chooseKernels(), true);
+    Q_UNUSED(chosen);
+    return kernelInstructionSet;
+}
+
+
+
+
+
+//This function forces a particular set of kernels to be used.  It is meant for benchmarking and testing, and returns
+//false (changing nothing) if the CPU can't run the requested instruction set.
+bool BlendKernels::setInstructionSet(InstructionSet instructionSet)
+{
+    static const bool chosen = (chooseKernels(), true);
+    Q_UNUSED(chosen);
+
+    if (instructionSet > bestSupportedInstructionSet())
+        return false;
+
+    useInstructionSet(instructionSet);
+    return true;
+}
+
+
+
+
+
+QString BlendKernels::instructionSetName(InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+    case sse2Instructions:
+        return "SSE2";
+    case avx2Instructions:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
+
+
+
+
+
+void BlendKernels::chooseKernels()
+{
+    useInstructionSet(bestSupportedInstructionSet());
+}
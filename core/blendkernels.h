@@ -0,0 +1,33 @@
+#ifndef BLENDKERNELS_H
+#define BLENDKERNELS_H
+
+#include <QtGlobal>
+#include <QString>
+
+//This class holds the inner loops used by ImageBlender and the video output.  Each loop works on a run of bytes, which lets the blender go
+//through its images one row at a time.  There are plain C++, SSE2 and AVX2 versions of each loop, and the fastest one
+//that the CPU supports is chosen the first time they are used.  All versions give exactly the same results.
+class BlendKernels
+{
+public:
+    enum InstructionSet {scalarInstructions = 0, sse2Instructions = 1, avx2Instructions = 2};
+
+    //Adds each of byteCount bytes to the matching total in sums.
+    static void addBytes(const uchar * bytes, quint32 * sums, int byteCount);
+
+    //Sets each of byteCount bytes to its total divided by sampleCount, rounded to the nearest integer (halves round up).
+    static void divideSums(const quint32 * sums, uchar * bytes, int byteCount, int sampleCount);
+
+    //Converts two rows of RGB32 pixels to YUV 4:2:0.
+    static void rgbToYuv420(const uchar * topRow, const uchar * bottomRow, int width, uchar * yTop, uchar * yBottom, uchar * u, uchar * v);
+
+    static InstructionSet bestSupportedInstructionSet();
+    static InstructionSet currentInstructionSet();
+    static bool setInstructionSet(InstructionSet instructionSet);
+    static QString instructionSetName(InstructionSet instructionSet);
+
+private:
+    static void chooseKernels();
+};
+
+#endif // BLENDKERNELS_H
@@ -0,0 +1,95 @@
+#include "camera.h"
+#include <QtGlobal>
+
+//How far the camera moves toward where it wants to be in each frame.  At 30 frames per second, it gets 90% of the way
+//there in about 3/4 of a second.
+static const double easing = 0.1;
+
+//The space left around the pattern, as a fraction of its size on each side
+static const double margin = 0.1;
+
+Camera::Camera()
+{
+    firstColumn = 0.0;
+    firstRow = 0.0;
+    cellsPerPixel = 1.0;
+    centerColumn = 0.0;
+    centerRow = 0.0;
+}
+
+
+
+
+
+//This function puts the camera back on startView, which is in cells, for images of outputSizeP pixels
+void Camera::reset(QRectF startView, QSize outputSizeP)
+{
+    outputSize = outputSizeP;
+    cellsPerPixel = qMax(startView.width() / outputSize.width(), startView.height() / outputSize.height());
+    centerColumn = startView.center().x();
+    centerRow = startView.center().y();
+
+    firstColumn = centerColumn - cellsPerPixel * outputSize.width() / 2.0;
+    firstRow = centerRow - cellsPerPixel * outputSize.height() / 2.0;
+}
+
+
+
+
+
+//This function puts the camera on the normal view of a grid image of imageSize pixels, with cellSize pixels per cell
+void Camera::resetToGrid(QSize imageSize, int cellSize)
+{
+    reset(QRectF(0.0, 0.0, double(imageSize.width()) / cellSize, double(imageSize.height()) / cellSize), imageSize);
+}
+
+
+
+
+
+//This function moves the camera one frame's worth toward a view that holds contentArea (in cells), plus a margin.  It
+//should be called once per frame.
+void Camera::follow(QRect contentArea)
+{
+    double paddedLeft = contentArea.left() - margin * contentArea.width();
+    double paddedTop = contentArea.top() - margin * contentArea.height();
+    double paddedRight = contentArea.left() + contentArea.width() * (1.0 + margin);
+    double paddedBottom = contentArea.top() + contentArea.height() * (1.0 + margin);
+
+    //Zoom out far enough for the padded area to fit, but never zoom in
+    double neededCellsPerPixel = qMax((paddedRight - paddedLeft) / outputSize.width(), (paddedBottom - paddedTop) / outputSize.height());
+    double targetCellsPerPixel = qMax(cellsPerPixel, neededCellsPerPixel);
+
+    //Only pan as far as needed to get the padded area into the view at the target zoom
+    double halfWidth = targetCellsPerPixel * outputSize.width() / 2.0;
+    double halfHeight = targetCellsPerPixel * outputSize.height() / 2.0;
+    double targetCenterColumn = qBound(paddedRight - halfWidth, centerColumn, paddedLeft + halfWidth);
+    double targetCenterRow = qBound(paddedBottom - halfHeight, centerRow, paddedTop + halfHeight);
+
+    cellsPerPixel += (targetCellsPerPixel - cellsPerPixel) * easing;
+    centerColumn += (targetCenterColumn - centerColumn) * easing;
+    centerRow += (targetCenterRow - centerRow) * easing;
+
+    firstColumn = centerColumn - cellsPerPixel * outputSize.width() / 2.0;
+    firstRow = centerRow - cellsPerPixel * outputSize.height() / 2.0;
+}
+
+
+
+
+
+//These functions save and restore the camera exactly, so a render started part way through can carry on the same
+//camera movement
+void Camera::writeCheckpoint(QDataStream & stream)
+{
+    stream << qint32(outputSize.width()) << qint32(outputSize.height());
+    stream << firstColumn << firstRow << cellsPerPixel << centerColumn << centerRow;
+}
+
+void Camera::readCheckpoint(QDataStream & stream)
+{
+    qint32 width, height;
+    stream >> width >> height;
+    stream >> firstColumn >> firstRow >> cellsPerPixel >> centerColumn >> centerRow;
+    outputSize = QSize(width, height);
+}
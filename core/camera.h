@@ -0,0 +1,34 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <QRect>
+#include <QRectF>
+#include <QSize>
+#include <QDataStream>
+
+//This class decides which part of the grid a render shows when the camera follows the pattern.  It starts on the
+//normal view and, as the pattern grows, pans and zooms out smoothly so that everything the ant has changed stays in
+//the frame.  It never zooms back in, so the picture doesn't pump in and out as the pattern changes shape.
+class Camera
+{
+public:
+    Camera();
+
+    void reset(QRectF startView, QSize outputSizeP);
+    void resetToGrid(QSize imageSize, int cellSize);
+    void follow(QRect contentArea);
+    void writeCheckpoint(QDataStream & stream);
+    void readCheckpoint(QDataStream & stream);
+
+    //The view: the cell (in display terms) at the image's top-left corner, and the number of cells per pixel
+    double firstColumn;
+    double firstRow;
+    double cellsPerPixel;
+
+private:
+    QSize outputSize;
+    double centerColumn;
+    double centerRow;
+};
+
+#endif // CAMERA_H
@@ -0,0 +1,189 @@
+#include "changeblender.h"
+#include <cstring>
+
+ChangeBlender::ChangeBlender()
+{
+    cellSize = 1;
+    samplesAdded = 0;
+    changesUsed = 0;
+    sampleMismatch = false;
+    changedPixelIndex = 0;
+    framePool = 0;
+}
+
+
+
+
+
+ChangeBlender::~ChangeBlender()
+{
+    delete [] changedPixelIndex;
+}
+
+
+
+
+
+//This function gets the blender ready for a new animation.  startImage is what the grid looks like before the first
+//sample is taken.
+void ChangeBlender::initialize(int cellSizeP, const QImage & startImage, QPoint firstCellP)
+{
+    cellSize = cellSizeP;
+    firstCell = firstCellP;
+    samplesAdded = 0;
+    changesUsed = 0;
+    sampleMismatch = false;
+
+    //Take a deep copy, as the grid's image will keep changing underneath us
+    currentImage = startImage.convertToFormat(QImage::Format_RGB32);
+    currentImage.detach();
+
+    int pixelCount = currentImage.width() * currentImage.height();
+    delete [] changedPixelIndex;
+    changedPixelIndex = new int [pixelCount];
+    for (int i = 0; i < pixelCount; i++)
+        changedPixelIndex[i] = -1;
+
+    changedPixels.clear();
+    colorStartSample.clear();
+    changedPixelSums.clear();
+}
+
+
+
+
+
+//This function takes in one sample.  Only the parts of sampleImage that can have changed since the last sample are
+//looked at: the cells in the change log that haven't been used yet, the cell under the ant and the area covered by
+//the counter and rules.
+void ChangeBlender::addSample(const QImage & sampleImage, const QVector<CellChange> & changes, QPoint antCell, QRect overlayArea)
+{
+    //The log is cleared at the start of each frame
+    if (samplesAdded == 0)
+        changesUsed = 0;
+
+    if ( (sampleImage.size() != currentImage.size())||(sampleImage.format() != QImage::Format_RGB32) )
+        sampleMismatch = true;
+
+    if (!sampleMismatch)
+    {
+        for (int i = changesUsed; i < changes.size(); i++)
+            checkArea(sampleImage, QRect((changes[i].column - firstCell.x()) * cellSize, (changes[i].row - firstCell.y()) * cellSize, cellSize, cellSize));
+        checkArea(sampleImage, QRect((antCell.x() - firstCell.x()) * cellSize, (antCell.y() - firstCell.y()) * cellSize, cellSize, cellSize));
+        checkArea(sampleImage, overlayArea);
+    }
+
+    changesUsed = changes.size();
+    samplesAdded++;
+}
+
+
+
+
+
+//This function compares an area of the sample to the current colors, and moves any pixels that differ over to their
+//new color.
+void ChangeBlender::checkArea(const QImage & sampleImage, QRect area)
+{
+    area &= currentImage.rect();
+    int width = currentImage.width();
+
+    for (int j = area.top(); j <= area.bottom(); j++)
+    {
+        const QRgb * sampleLine = reinterpret_cast<const QRgb *>(sampleImage.constScanLine(j));
+        QRgb * currentLine = reinterpret_cast<QRgb *>(currentImage.scanLine(j));
+
+        for (int i = area.left(); i <= area.right(); i++)
+        {
+            if (sampleLine[i] == currentLine[i])
+                continue;
+
+            //The first change to a pixel in this frame gives it a place in the lists
+            int & index = changedPixelIndex[j * width + i];
+            if (index == -1)
+            {
+                index = changedPixels.size();
+                changedPixels.append(j * width + i);
+                colorStartSample.append(0);
+                for (int k = 0; k < 4; k++)
+                    changedPixelSums.append(0);
+            }
+
+            //Add the old color once for every sample it was showing
+            quint32 weight = quint32(samplesAdded - colorStartSample[index]);
+            quint32 * sums = changedPixelSums.data() + 4 * index;
+            QRgb oldColor = currentLine[i];
+            for (int k = 0; k < 4; k++)
+                sums[k] += ((oldColor >> (8 * k)) & 0xff) * weight;
+
+            colorStartSample[index] = samplesAdded;
+            currentLine[i] = sampleLine[i];
+        }
+    }
+}
+
+
+
+
+
+//This function finishes the frame.  Unchanged pixels are simply their current color.  Changed pixels get their
+//current color added in for the rest of the frame and are then rounded to the nearest integer the same way as
+//ImageBlender: (2 * sum + count) / (2 * count).
+QImage ChangeBlender::blendImages()
+{
+    int sampleCount = samplesAdded;
+    bool mismatch = sampleMismatch;
+    samplesAdded = 0;
+    sampleMismatch = false;
+
+    QImage blendedImage;
+    if ( (sampleCount > 0)&&(!mismatch)&&(!currentImage.isNull()) )
+    {
+        //The blend starts as the current colors, copied into an image from the pool if possible
+        if (framePool != 0)
+            blendedImage = framePool->lease();
+        if ( (blendedImage.size() == currentImage.size())&&(blendedImage.format() == currentImage.format())&&
+             (blendedImage.bytesPerLine() == currentImage.bytesPerLine()) )
+            memcpy(blendedImage.bits(), currentImage.constBits(), currentImage.sizeInBytes());
+        else
+            blendedImage = currentImage.copy();
+        quint32 doubleCount = 2 * sampleCount;
+
+        for (int p = 0; p < changedPixels.size(); p++)
+        {
+            int pixel = changedPixels[p];
+            QRgb * line = reinterpret_cast<QRgb *>(blendedImage.scanLine(pixel / currentImage.width()));
+            QRgb color = line[pixel % currentImage.width()];
+
+            quint32 weight = quint32(sampleCount - colorStartSample[p]);
+            const quint32 * sums = changedPixelSums.constData() + 4 * p;
+            QRgb blended = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                quint32 sum = sums[k] + ((color >> (8 * k)) & 0xff) * weight;
+                blended |= ((2 * sum + sampleCount) / doubleCount) << (8 * k);
+            }
+            line[pixel % currentImage.width()] = blended;
+        }
+    }
+
+    //Start the next frame with no changed pixels
+    for (int p = 0; p < changedPixels.size(); p++)
+        changedPixelIndex[changedPixels[p]] = -1;
+    changedPixels.clear();
+    colorStartSample.clear();
+    changedPixelSums.clear();
+
+    return blendedImage;
+}
+
+
+
+
+
+//This function sets the pool that blended images are leased from.  Whoever ends up with them should release them
+//back to the pool once they are done.
+void ChangeBlender::setFramePool(FramePool * framePoolP)
+{
+    framePool = framePoolP;
+}
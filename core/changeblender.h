@@ -0,0 +1,52 @@
+#ifndef CHANGEBLENDER_H
+#define CHANGEBLENDER_H
+
+#include <QImage>
+#include <QVector>
+#include "antgrid.h"
+#include "framepool.h"
+
+//This class makes the same blended frames as ImageBlender, but without adding up every sample image.  Between two
+//samples, only the cells the ant changed (plus the ant itself and the counter) look any different, so for each pixel
+//it just remembers its current color and the sample where that color started.  When a pixel changes, the old color is
+//added to the pixel's totals, weighted by the number of samples it lasted.  Pixels that never change during a frame
+//keep their color, so the cost of a frame depends on how much changes in it rather than on the number of samples.
+class ChangeBlender
+{
+public:
+    ChangeBlender();
+    ~ChangeBlender();
+
+    void initialize(int cellSizeP, const QImage & startImage, QPoint firstCellP = QPoint(0, 0));
+    void addSample(const QImage & sampleImage, const QVector<CellChange> & changes, QPoint antCell, QRect overlayArea);
+    QImage blendImages();
+    void setFramePool(FramePool * framePoolP);
+
+private:
+    int cellSize;
+
+    //The cell (in display terms) at the top-left corner of the images, for blending part of the grid
+    QPoint firstCell;
+    int samplesAdded;
+    int changesUsed;
+    bool sampleMismatch;
+
+    //Where the blended images come from, if anywhere
+    FramePool * framePool;
+
+    //The color each pixel has had since it last changed
+    QImage currentImage;
+
+    //For each pixel, its index in the lists below if it has changed during this frame, or -1 if it hasn't
+    int * changedPixelIndex;
+
+    //The pixels that have changed during this frame, the sample at which each took on its current color, and the
+    //totals of their four bytes over the samples before that
+    QVector<int> changedPixels;
+    QVector<int> colorStartSample;
+    QVector<quint32> changedPixelSums;
+
+    void checkArea(const QImage & sampleImage, QRect area);
+};
+
+#endif // CHANGEBLENDER_H
@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Links a program against the core library.  Include this from the program's .pro file, in a directory next to core.
+#
+#-------------------------------------------------
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+win32:CONFIG(release, debug|release): CORE_LIB_DIR = $$OUT_PWD/../core/release
+else:win32:CONFIG(debug, debug|release): CORE_LIB_DIR = $$OUT_PWD/../core/debug
+else: CORE_LIB_DIR = $$OUT_PWD/../core
+
+LIBS += -L$$CORE_LIB_DIR -lantcore
+
+win32-g++: PRE_TARGETDEPS += $$CORE_LIB_DIR/libantcore.a
+else:win32: PRE_TARGETDEPS += $$CORE_LIB_DIR/antcore.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/libantcore.a
+
+#The poster writer in the core library streams through zlib
+unix:LIBS += -lz
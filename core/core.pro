@@ -0,0 +1,69 @@
+#-------------------------------------------------
+#
+# Static library with everything that doesn't need widgets: the grids and the ant, the settings and rules, the
+# blenders, the render pipeline and the image, video and poster writers.
+#
+#-------------------------------------------------
+
+QT       += core gui
+CONFIG += c++11 staticlib
+
+TARGET = antcore
+TEMPLATE = lib
+
+SOURCES += antsettings.cpp \
+    grid.cpp \
+    antgrid.cpp \
+    imageblender.cpp \
+    antcounter.cpp \
+    gridpyramid.cpp \
+    blendkernels.cpp \
+    changeblender.cpp \
+    workerpool.cpp \
+    framewriter.cpp \
+    renderpipeline.cpp \
+    videostream.cpp \
+    deltaframefile.cpp \
+    framepool.cpp \
+    renderoutput.cpp \
+    posterwriter.cpp \
+    camera.cpp \
+    rulesearch.cpp \
+    antsimulation.cpp \
+    renderjob.cpp \
+    jobqueue.cpp \
+    searchengine.cpp \
+    counterrandom.cpp \
+    ruleclassifier.cpp
+
+HEADERS  += antsettings.h \
+    staterule.h \
+    antdirection.h \
+    grid.h \
+    antgrid.h \
+    imageblender.h \
+    antcounter.h \
+    gridpyramid.h \
+    blendkernels.h \
+    changeblender.h \
+    workerpool.h \
+    framewriter.h \
+    renderpipeline.h \
+    videostream.h \
+    deltaframefile.h \
+    framepool.h \
+    renderoutput.h \
+    posterwriter.h \
+    camera.h \
+    rulesearch.h \
+    antsimulation.h \
+    renderjob.h \
+    jobqueue.h \
+    searchengine.h \
+    counterrandom.h \
+    ruleclassifier.h
+
+unix:QMAKE_CXXFLAGS += -std=c++11
+
+#The poster writer streams through zlib.  Qt has its own copy on Windows.
+win32:INCLUDEPATH += $$[QT_INSTALL_HEADERS]/QtZlib
@@ -0,0 +1,78 @@
+#include "counterrandom.h"
+
+//The SplitMix64 finalizer, which mixes every bit of its input into every bit of the result
+static quint64 mix(quint64 x)
+{
+    x = (x ^ (x >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
+CounterRandom::CounterRandom(quint64 seedP)
+{
+    randomSeed = seedP;
+    stream = 0;
+    counter = 0;
+}
+
+
+
+
+
+void CounterRandom::seed(quint64 seedP)
+{
+    randomSeed = seedP;
+    stream = 0;
+    counter = 0;
+}
+
+quint64 CounterRandom::seedValue()
+{
+    return randomSeed;
+}
+
+//This function moves to the start of a stream
+void CounterRandom::setStream(quint64 streamP)
+{
+    stream = streamP;
+    counter = 0;
+}
+
+
+
+
+
+quint64 CounterRandom::next()
+{
+    return hash(randomSeed, stream, counter++);
+}
+
+
+
+
+
+//This function returns a number from 0 to limit-1, with each one equally likely.  The few numbers at the top of the
+//64-bit range that would make the lower results more likely are skipped.
+quint64 CounterRandom::below(quint64 limit)
+{
+    if (limit <= 1)
+        return 0;
+
+    quint64 threshold = (0 - limit) % limit;
+    while (true)
+    {
+        quint64 value = next();
+        if (value >= threshold)
+            return value % limit;
+    }
+}
+
+
+
+
+
+quint64 CounterRandom::hash(quint64 seedP, quint64 streamP, quint64 counterP)
+{
+    quint64 x = mix(seedP ^ (streamP * Q_UINT64_C(0x9E3779B97F4A7C15)));
+    return mix(x + counterP * Q_UINT64_C(0xD1B54A32D192ED03));
+}
@@ -0,0 +1,30 @@
+#ifndef COUNTERRANDOM_H
+#define COUNTERRANDOM_H
+
+#include <QtGlobal>
+
+//This class makes random numbers that depend only on a seed, a stream number and how far along the stream they are.
+//Each number is a hash of those three, rather than the next step of a generator's state, so the numbers for any stream
+//can be made again without making the ones before it.  The searches use one stream per rule, which means a rule comes
+//out the same whichever thread, process or machine makes it.  The hash is the same everywhere, unlike the standard
+//library's distributions.
+class CounterRandom
+{
+public:
+    CounterRandom(quint64 seedP = 0);
+
+    void seed(quint64 seedP);
+    quint64 seedValue();
+    void setStream(quint64 streamP);
+    quint64 next();
+    quint64 below(quint64 limit);
+
+    static quint64 hash(quint64 seedP, quint64 streamP, quint64 counterP);
+
+private:
+    quint64 randomSeed;
+    quint64 stream;
+    quint64 counter;
+};
+
+#endif // COUNTERRANDOM_H
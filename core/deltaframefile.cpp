@@ -0,0 +1,430 @@
+#include "deltaframefile.h"
+#include <QDataStream>
+#include <cstring>
+
+static const char fileMagic[8] = {'A', 'N', 'T', 'D', 'E', 'L', 'T', 'A'};
+static const quint32 fileVersion = 2;
+static const qint64 frameCountOffset = 24;
+
+//Changes are looked for in bands of this many rows, and each band with a change gets its own rectangle.  This keeps
+//the counter in one corner and the ant somewhere else from making one huge rectangle.
+static const int bandHeight = 16;
+
+DeltaFrameFile::DeltaFrameFile()
+{
+    writing = false;
+    keyframeInterval = 1;
+    firstNumber = 0;
+    previousFrameNumber = -1;
+}
+
+
+
+
+
+DeltaFrameFile::~DeltaFrameFile()
+{
+    close();
+}
+
+
+
+
+
+//This function starts a new file.  Every frame written to it must be frameSizeP.  firstFrameNumberP is the number the
+//render gives the first frame, which is kept so the frames can be extracted under the same numbers.
+bool DeltaFrameFile::create(const QString & path, QSize frameSizeP, int keyframeIntervalP, int firstFrameNumberP)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    writing = true;
+    size = frameSizeP;
+    keyframeInterval = qMax(1, keyframeIntervalP);
+    firstNumber = firstFrameNumberP;
+
+    //The frame count and index offset are filled in by finish
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(fileMagic, 8);
+    stream << fileVersion << qint32(size.width()) << qint32(size.height()) << quint32(keyframeInterval) << quint32(0) << quint64(0)
+           << qint32(firstNumber);
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+
+
+
+bool DeltaFrameFile::appendFrame(const QImage & frame)
+{
+    if ( (!writing)||(frame.size() != size) )
+        return false;
+
+    QImage rgbFrame = frame;
+    if (rgbFrame.format() != QImage::Format_RGB32)
+        rgbFrame = rgbFrame.convertToFormat(QImage::Format_RGB32);
+
+    //Keyframes are one rectangle covering everything.  Other frames only have what changed.
+    bool keyframe = (frameOffsets.size() % keyframeInterval == 0);
+    QVector<QRect> rects;
+    if (keyframe)
+        rects.append(rgbFrame.rect());
+    else
+        rects = findChangedRects(rgbFrame);
+
+    return writeFrameRecord(rgbFrame, rects, keyframe);
+}
+
+
+
+
+
+//This function adds a frame that is the same as the one before.  Unless it is due to be a keyframe, it is stored as a
+//frame with no rectangles, so it takes up just a few bytes.
+bool DeltaFrameFile::appendRepeatedFrame()
+{
+    if ( (!writing)||(previousFrameNumber < 0) )
+        return false;
+
+    if (frameOffsets.size() % keyframeInterval == 0)
+        return appendFrame(previousFrame);
+
+    return writeFrameRecord(previousFrame, QVector<QRect>(), false);
+}
+
+
+
+
+
+bool DeltaFrameFile::writeFrameRecord(const QImage & rgbFrame, const QVector<QRect> & rects, bool keyframe)
+{
+    //Pack the rectangles' pixels as RGB bytes and compress them together
+    int byteCount = 0;
+    for (int i = 0; i < rects.size(); i++)
+        byteCount += rects[i].width() * rects[i].height() * 3;
+    QByteArray pixels(byteCount, 0);
+    uchar * output = reinterpret_cast<uchar *>(pixels.data());
+    for (int i = 0; i < rects.size(); i++)
+    {
+        for (int y = rects[i].top(); y <= rects[i].bottom(); y++)
+        {
+            const QRgb * line = reinterpret_cast<const QRgb *>(rgbFrame.constScanLine(y));
+            for (int x = rects[i].left(); x <= rects[i].right(); x++)
+            {
+                *output++ = uchar(qRed(line[x]));
+                *output++ = uchar(qGreen(line[x]));
+                *output++ = uchar(qBlue(line[x]));
+            }
+        }
+    }
+    QByteArray compressed;
+    if (!pixels.isEmpty())
+        compressed = qCompress(pixels);
+
+    frameOffsets.append(file.pos());
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << quint32(keyframe ? 1 : 0) << quint32(rects.size());
+    for (int i = 0; i < rects.size(); i++)
+        stream << qint32(rects[i].x()) << qint32(rects[i].y()) << qint32(rects[i].width()) << qint32(rects[i].height());
+    stream << quint32(compressed.size());
+    stream.writeRawData(compressed.constData(), compressed.size());
+
+    previousFrame = rgbFrame;
+    previousFrameNumber = frameOffsets.size() - 1;
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+
+
+
+//This function writes the index and fills in the header.  The file is closed afterwards.
+bool DeltaFrameFile::finish()
+{
+    if (!writing)
+        return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint64 indexOffset = quint64(file.pos());
+    for (int i = 0; i < frameOffsets.size(); i++)
+        stream << quint64(frameOffsets[i]);
+
+    bool succeeded = file.seek(frameCountOffset);
+    stream << quint32(frameOffsets.size()) << indexOffset;
+    succeeded = ( (succeeded)&&(stream.status() == QDataStream::Ok) );
+
+    writing = false;
+    close();
+    return succeeded;
+}
+
+
+
+
+
+bool DeltaFrameFile::open(const QString & path)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    char magic[8];
+    quint32 version, interval, count;
+    qint32 width, height;
+    quint64 indexOffset;
+    if (stream.readRawData(magic, 8) != 8)
+        return false;
+    stream >> version >> width >> height >> interval >> count >> indexOffset;
+    if ( (stream.status() != QDataStream::Ok)||(memcmp(magic, fileMagic, 8) != 0)||(version < 1)||(version > fileVersion) )
+        return false;
+
+    //Version 1 files didn't record the first frame's number
+    qint32 firstFrameNumberInFile = 0;
+    if (version >= 2)
+        stream >> firstFrameNumberInFile;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+    if ( (width <= 0)||(height <= 0)||(interval == 0) )
+        return false;
+
+    size = QSize(width, height);
+    keyframeInterval = int(interval);
+    firstNumber = firstFrameNumberInFile;
+
+    //A file that was never finished has no index, so the frames have to be found one by one
+    if (indexOffset == 0)
+        return scanFrames(file.pos());
+
+    if (!file.seek(qint64(indexOffset)))
+        return false;
+    frameOffsets.resize(int(count));
+    for (int i = 0; i < int(count); i++)
+    {
+        quint64 offset;
+        stream >> offset;
+        frameOffsets[i] = qint64(offset);
+    }
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+
+
+
+//This function returns a frame, or a null image if it can't be read.  Frames are quickest to read in order, as
+//each one is built on the one before.
+QImage DeltaFrameFile::readFrame(int frameNumber)
+{
+    if ( (writing)||(frameNumber < 0)||(frameNumber >= frameOffsets.size()) )
+        return QImage();
+
+    //Start from the keyframe before this frame, unless the last frame read is already on the way
+    int firstFrame = frameNumber - frameNumber % keyframeInterval;
+    if ( (previousFrameNumber >= firstFrame)&&(previousFrameNumber <= frameNumber) )
+        firstFrame = previousFrameNumber + 1;
+    else
+        previousFrame = QImage(size, QImage::Format_RGB32);
+
+    for (int i = firstFrame; i <= frameNumber; i++)
+    {
+        if (!readFrameRecord(frameOffsets[i], &previousFrame))
+        {
+            previousFrameNumber = -1;
+            return QImage();
+        }
+        previousFrameNumber = i;
+    }
+
+    return previousFrame.copy();
+}
+
+
+
+
+
+int DeltaFrameFile::frameCount()
+{
+    return frameOffsets.size();
+}
+
+QSize DeltaFrameFile::frameSize()
+{
+    return size;
+}
+
+int DeltaFrameFile::firstFrameNumber()
+{
+    return firstNumber;
+}
+
+
+
+
+
+//This function closes the file.  A file being written should be finished first, or it won't have an index.
+void DeltaFrameFile::close()
+{
+    file.close();
+    writing = false;
+    frameOffsets.clear();
+    previousFrame = QImage();
+    previousFrameNumber = -1;
+}
+
+
+
+
+
+//This function compares a frame to the one before it and returns a rectangle around the changes in each band of rows.
+QVector<QRect> DeltaFrameFile::findChangedRects(const QImage & frame)
+{
+    QVector<QRect> rects;
+    int width = size.width();
+
+    for (int bandTop = 0; bandTop < size.height(); bandTop += bandHeight)
+    {
+        int bandBottom = qMin(bandTop + bandHeight, size.height()) - 1;
+        int left = width;
+        int right = -1;
+        int top = -1;
+        int bottom = -1;
+
+        for (int y = bandTop; y <= bandBottom; y++)
+        {
+            const QRgb * line = reinterpret_cast<const QRgb *>(frame.constScanLine(y));
+            const QRgb * previousLine = reinterpret_cast<const QRgb *>(previousFrame.constScanLine(y));
+            if (memcmp(line, previousLine, width * sizeof(QRgb)) == 0)
+                continue;
+
+            //Only the parts of the row outside of what's already been found need to be looked at
+            int x = 0;
+            while ( (x < left)&&(line[x] == previousLine[x]) )
+                x++;
+            left = qMin(left, x);
+            x = width - 1;
+            while ( (x > right)&&(line[x] == previousLine[x]) )
+                x--;
+            right = qMax(right, x);
+
+            if (top < 0)
+                top = y;
+            bottom = y;
+        }
+
+        if (top >= 0)
+            rects.append(QRect(QPoint(left, top), QPoint(right, bottom)));
+    }
+
+    return rects;
+}
+
+
+
+
+
+//This function reads the frame at offset in the file and draws its rectangles onto frame.
+bool DeltaFrameFile::readFrameRecord(qint64 offset, QImage * frame)
+{
+    if (!file.seek(offset))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 keyframe, rectCount;
+    stream >> keyframe >> rectCount;
+    if ( (stream.status() != QDataStream::Ok)||(rectCount > quint32(size.height())) )
+        return false;
+
+    QVector<QRect> rects;
+    rects.resize(int(rectCount));
+    qint64 byteCount = 0;
+    for (int i = 0; i < rects.size(); i++)
+    {
+        qint32 x, y, width, height;
+        stream >> x >> y >> width >> height;
+        rects[i] = QRect(x, y, width, height);
+        if ( (rects[i].isEmpty())||(!frame->rect().contains(rects[i])) )
+            return false;
+        byteCount += qint64(width) * height * 3;
+    }
+
+    quint32 compressedSize;
+    stream >> compressedSize;
+    if (stream.status() != QDataStream::Ok)
+        return false;
+    if (rects.isEmpty())
+        return (compressedSize == 0);
+    QByteArray compressed(int(compressedSize), 0);
+    if (stream.readRawData(compressed.data(), compressed.size()) != compressed.size())
+        return false;
+
+    QByteArray pixels = qUncompress(compressed);
+    if (pixels.size() != byteCount)
+        return false;
+
+    const uchar * input = reinterpret_cast<const uchar *>(pixels.constData());
+    for (int i = 0; i < rects.size(); i++)
+    {
+        for (int y = rects[i].top(); y <= rects[i].bottom(); y++)
+        {
+            QRgb * line = reinterpret_cast<QRgb *>(frame->scanLine(y));
+            for (int x = rects[i].left(); x <= rects[i].right(); x++)
+            {
+                line[x] = qRgb(input[0], input[1], input[2]);
+                input += 3;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+
+
+
+//This function finds the frames of an unfinished file by reading the size of each one in turn.  A frame cut short at
+//the end is left out.
+bool DeltaFrameFile::scanFrames(qint64 offset)
+{
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    while (file.seek(offset))
+    {
+        quint32 keyframe, rectCount, compressedSize;
+        stream >> keyframe >> rectCount;
+        if ( (stream.status() != QDataStream::Ok)||(rectCount > quint32(size.height())) )
+            break;
+        if (!file.seek(offset + 8 + 16 * qint64(rectCount)))
+            break;
+        stream >> compressedSize;
+        if (stream.status() != QDataStream::Ok)
+            break;
+
+        qint64 nextOffset = offset + 12 + 16 * qint64(rectCount) + compressedSize;
+        if (nextOffset > file.size())
+            break;
+
+        frameOffsets.append(offset);
+        offset = nextOffset;
+    }
+
+    return !frameOffsets.isEmpty();
+}
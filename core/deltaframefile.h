@@ -0,0 +1,67 @@
+#ifndef DELTAFRAMEFILE_H
+#define DELTAFRAMEFILE_H
+
+#include <QImage>
+#include <QString>
+#include <QFile>
+#include <QVector>
+#include <QRect>
+
+//This class reads and writes packed delta frame files, which hold a whole animation in one file.  Most frames are
+//stored as just the rectangles that changed since the frame before, and every keyframeInterval frames a whole frame
+//is stored so any frame can be found without decoding from the start.  Everything is compressed with zlib, so nothing
+//is lost.
+//
+//The file is little endian:
+//  header:  "ANTDELTA", version, width, height, keyframe interval, frame count, index offset (8 bytes), first frame
+//           number (version 2 on; 0 in version 1 files)
+//  frames:  keyframe flag, rectangle count, (x, y, width, height) for each rectangle, compressed size, then the
+//           compressed RGB bytes of the rectangles, one after another
+//  index:   the offset of each frame
+//If the program stops before the file is finished, the frame count and index offset are left at zero and a reader
+//finds the frames by going through them in order instead.
+class DeltaFrameFile
+{
+public:
+    DeltaFrameFile();
+    ~DeltaFrameFile();
+
+    //Writing
+    bool create(const QString & path, QSize frameSizeP, int keyframeIntervalP, int firstFrameNumberP = 0);
+    bool appendFrame(const QImage & frame);
+    bool appendRepeatedFrame();
+    bool finish();
+
+    //Reading
+    bool open(const QString & path);
+    QImage readFrame(int frameNumber);
+    int frameCount();
+    QSize frameSize();
+    int firstFrameNumber();
+
+    void close();
+
+private:
+    QFile file;
+    bool writing;
+    QSize size;
+    int keyframeInterval;
+
+    //The number the render gave the first frame: 0 if it saved the zero frame, and 1 if not.  The frames in the file
+    //are numbered from 0 whatever it is.
+    int firstNumber;
+
+    //The offset of each frame in the file
+    QVector<qint64> frameOffsets;
+
+    //The frame written or read last, which the next one is built on.  previousFrameNumber is -1 if there isn't one.
+    QImage previousFrame;
+    int previousFrameNumber;
+
+    QVector<QRect> findChangedRects(const QImage & frame);
+    bool writeFrameRecord(const QImage & frame, const QVector<QRect> & rects, bool keyframe);
+    bool readFrameRecord(qint64 offset, QImage * frame);
+    bool scanFrames(qint64 offset);
+};
+
+#endif // DELTAFRAMEFILE_H
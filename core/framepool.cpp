@@ -0,0 +1,91 @@
+#include "framepool.h"
+#include <QMutexLocker>
+
+FramePool::FramePool()
+{
+    frameFormat = QImage::Format_RGB32;
+    allocations = 0;
+}
+
+
+
+
+
+//This function sets the size and format of the images the pool hands out, and makes reserveCount of them now so the
+//render doesn't have to stop and make them later.  Any images of another size or format are let go.
+void FramePool::setFrameFormat(QSize frameSizeP, QImage::Format frameFormatP, int reserveCount)
+{
+    QMutexLocker locker(&mutex);
+
+    if ( (frameSizeP != frameSize)||(frameFormatP != frameFormat) )
+        freeImages.clear();
+    frameSize = frameSizeP;
+    frameFormat = frameFormatP;
+
+    while (freeImages.size() < reserveCount)
+    {
+        freeImages.append(QImage(frameSize, frameFormat));
+        allocations++;
+    }
+}
+
+
+
+
+
+//This function returns an image of the pool's size and format that nothing else is using.  Its contents are whatever
+//was last drawn in it, so the caller has to fill every pixel.
+QImage FramePool::lease()
+{
+    QMutexLocker locker(&mutex);
+
+    for (int i = freeImages.size() - 1; i >= 0; i--)
+    {
+        if (freeImages[i].isDetached())
+        {
+            QImage image = freeImages[i];
+            freeImages.remove(i);
+            return image;
+        }
+    }
+
+    allocations++;
+    return QImage(frameSize, frameFormat);
+}
+
+
+
+
+
+//This function hands an image back to the pool and clears the caller's reference to it.  Images that aren't the
+//pool's size and format are just let go.
+void FramePool::release(QImage & image)
+{
+    QMutexLocker locker(&mutex);
+
+    if ( (!image.isNull())&&(image.size() == frameSize)&&(image.format() == frameFormat) )
+        freeImages.append(image);
+    image = QImage();
+}
+
+
+
+
+
+//This function lets go of all of the free images, to give the memory back when the pool isn't needed for a while.
+void FramePool::clear()
+{
+    QMutexLocker locker(&mutex);
+    freeImages.clear();
+}
+
+
+
+
+
+//This function returns how many images the pool has made, which stops going up once a render has settled down.
+int FramePool::imagesAllocated()
+{
+    QMutexLocker locker(&mutex);
+    return allocations;
+}
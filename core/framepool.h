@@ -0,0 +1,33 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <QImage>
+#include <QVector>
+#include <QMutex>
+
+//This class keeps a set of frame-sized images that are used over and over, so a render doesn't allocate (and the
+//system doesn't have to zero) a new frame's worth of memory for every frame.  The blenders lease an image to draw a
+//frame into and the frame writer hands it back once it has been saved.  An image handed back while something else
+//still has a reference to it (the GUI showing it, say) isn't leased out again until that reference is gone, as
+//writing to it would just make a copy.  New images are only made when none are free, so once a render is going the
+//pool stays the same size.  All the functions are safe to call from any thread.
+class FramePool
+{
+public:
+    FramePool();
+
+    void setFrameFormat(QSize frameSizeP, QImage::Format frameFormatP, int reserveCount);
+    QImage lease();
+    void release(QImage & image);
+    void clear();
+    int imagesAllocated();
+
+private:
+    QMutex mutex;
+    QSize frameSize;
+    QImage::Format frameFormat;
+    QVector<QImage> freeImages;
+    int allocations;
+};
+
+#endif // FRAMEPOOL_H
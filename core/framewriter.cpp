@@ -0,0 +1,549 @@
+#include "framewriter.h"
+#include <QImageWriter>
+#include <QFileInfo>
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+//Each of the writer's threads just saves frames until there are none left
+class FrameWriterThread : public QThread
+{
+public:
+    FrameWriterThread(FrameWriter * writerP)
+    {
+        writer = writerP;
+    }
+
+protected:
+    void run()
+    {
+        FrameWriter::QueuedFrame frame;
+        while (writer->takeFrame(&frame))
+        {
+            bool succeeded = writer->saveFrame(frame);
+            writer->releaseImage(frame.image); //let go of the frame's memory before waiting for the next one
+            writer->frameDone(frame.sequenceNumber, succeeded);
+        }
+    }
+
+private:
+    FrameWriter * writer;
+};
+
+
+
+
+
+FrameWriter::FrameWriter()
+{
+    queueDepth = 1;
+    stopping = false;
+    pngCompression = defaultCompression;
+    reduceColors = false;
+    stream = 0;
+    framePool = 0;
+    lastSequenceNumber = -1;
+    firstInOrder = 0;
+    nextInOrder = 0;
+    failures = 0;
+}
+
+
+
+
+
+FrameWriter::~FrameWriter()
+{
+    cancel();
+}
+
+
+
+
+
+//This function starts the threads.  queueDepthP is the number of frames that can be waiting to be saved, on top of
+//those being saved.  firstSequenceNumber is the number of the first frame that will be written.
+void FrameWriter::start(int threadCount, int queueDepthP, int firstSequenceNumber)
+{
+    //Make sure any previous run is over
+    cancel();
+    stream = 0;
+
+    queueDepth = qMax(1, queueDepthP);
+    stopping = false;
+    firstInOrder = firstSequenceNumber;
+    nextInOrder = firstSequenceNumber;
+    finishedEarly.clear();
+    failures = 0;
+    lastSequenceNumber = -1;
+
+    mutex.lock();
+    for (int i = 0; i < qMax(1, threadCount); i++)
+    {
+        threads.append(new FrameWriterThread(this));
+        threads.last()->start();
+    }
+    mutex.unlock();
+}
+
+
+
+
+
+//This function starts a single thread that writes every frame into the passed stream, in the order they are queued.
+//The sequence numbers are the frame numbers, so the stream is told the first one.
+void FrameWriter::startStream(VideoStream * streamP, int queueDepthP, int firstSequenceNumber)
+{
+    start(1, queueDepthP, firstSequenceNumber);
+    stream = streamP;
+    stream->setFirstFrameNumber(firstSequenceNumber);
+}
+
+
+
+
+
+//This function adds a frame to the queue.  If the queue is full, it waits for one of the threads to take a frame
+//first.  It returns false if the writer isn't running.
+bool FrameWriter::write(const QImage & image, const QString & fileName, int sequenceNumber)
+{
+    QMutexLocker locker(&mutex);
+
+    while ( (!stopping)&&(queue.size() >= queueDepth) )
+        frameTaken.wait(&mutex);
+    if ( (stopping)||(threads.isEmpty()) )
+        return false;
+
+    QueuedFrame frame;
+    frame.image = image;
+    frame.fileName = fileName;
+    frame.sequenceNumber = sequenceNumber;
+    frame.pngCompression = pngCompression;
+    frame.reduceColors = reduceColors;
+    frame.repeatOf = -1;
+    queue.enqueue(frame);
+
+    lastFileName = fileName;
+    lastSequenceNumber = sequenceNumber;
+
+    frameQueued.wakeOne();
+    return true;
+}
+
+
+
+
+
+//This function queues a frame that is exactly the same as the last one passed to write.  Instead of being encoded
+//again, the earlier file is linked or copied, or the stream repeats its last frame.
+bool FrameWriter::writeRepeat(const QString & fileName, int sequenceNumber)
+{
+    QMutexLocker locker(&mutex);
+
+    while ( (!stopping)&&(queue.size() >= queueDepth) )
+        frameTaken.wait(&mutex);
+    if ( (stopping)||(threads.isEmpty())||(lastSequenceNumber < 0) )
+        return false;
+
+    QueuedFrame frame;
+    frame.fileName = fileName;
+    frame.sequenceNumber = sequenceNumber;
+    frame.pngCompression = pngCompression;
+    frame.reduceColors = reduceColors;
+    frame.repeatOf = lastSequenceNumber;
+    frame.sourceFileName = lastFileName;
+    queue.enqueue(frame);
+
+    frameQueued.wakeOne();
+    return true;
+}
+
+
+
+
+
+//This function waits for every queued frame to be saved and then stops the threads.
+void FrameWriter::finish()
+{
+    mutex.lock();
+    stopping = true;
+    frameQueued.wakeAll();
+    frameTaken.wakeAll();
+    mutex.unlock();
+
+    stopThreads();
+}
+
+
+
+
+
+//This function throws away the frames that haven't been started, handing their images back to the pool, waits for the
+//ones being saved and then stops the threads.
+void FrameWriter::cancel()
+{
+    mutex.lock();
+    while (!queue.isEmpty())
+    {
+        QueuedFrame frame = queue.dequeue();
+        releaseImage(frame.image);
+    }
+    stopping = true;
+    frameQueued.wakeAll();
+    frameTaken.wakeAll();
+    mutex.unlock();
+
+    stopThreads();
+}
+
+
+
+
+
+//finish and cancel can be called from different threads at the same time, so the list of threads is taken out under
+//the mutex and only one of them deletes the threads.
+void FrameWriter::stopThreads()
+{
+    mutex.lock();
+    QVector<QThread *> threadsToStop = threads;
+    threads.clear();
+    mutex.unlock();
+
+    for (int i = 0; i < threadsToStop.size(); i++)
+    {
+        threadsToStop[i]->wait();
+        delete threadsToStop[i];
+    }
+
+    //The stream's thread has finished with it, so the output can be closed
+    if ( (stream != 0)&&(!threadsToStop.isEmpty()) )
+        stream->close();
+}
+
+
+
+
+
+//This function sets the PNG compression used for frames written from now on.
+void FrameWriter::setPngCompression(int pngCompressionP)
+{
+    QMutexLocker locker(&mutex);
+    pngCompression = pngCompressionP;
+}
+
+
+
+
+
+//This function turns on or off saving frames with few enough colors as palette images, for frames written from now on.
+//Only PNG and BMP files are affected.
+void FrameWriter::setPaletteReduction(bool enabled)
+{
+    QMutexLocker locker(&mutex);
+    reduceColors = enabled;
+}
+
+
+
+
+
+//This function sets the pool that frames are handed back to once they have been saved.  It must be called before
+//the threads are started.
+void FrameWriter::setFramePool(FramePool * framePoolP)
+{
+    framePool = framePoolP;
+}
+
+
+
+
+
+//This function returns how many frames, counting from the first, have been saved with no gaps.
+int FrameWriter::framesWrittenInOrder()
+{
+    QMutexLocker locker(&mutex);
+    return nextInOrder - firstInOrder;
+}
+
+
+
+
+
+int FrameWriter::failedFrameCount()
+{
+    QMutexLocker locker(&mutex);
+    return failures;
+}
+
+
+
+
+
+//This function hands the next frame to a thread.  It waits while the queue is empty, and returns false once the
+//writer is stopping and there is nothing left to do.
+bool FrameWriter::takeFrame(QueuedFrame * frame)
+{
+    QMutexLocker locker(&mutex);
+
+    while ( (!stopping)&&(queue.isEmpty()) )
+        frameQueued.wait(&mutex);
+    if (queue.isEmpty())
+        return false;
+
+    *frame = queue.dequeue();
+
+    frameTaken.wakeOne();
+    return true;
+}
+
+
+
+
+
+//This function is called by the threads once they are done with a frame's image.  It clears the reference passed.
+void FrameWriter::releaseImage(QImage & image)
+{
+    if (framePool != 0)
+        framePool->release(image);
+    else
+        image = QImage();
+}
+
+
+
+
+
+//This function is called by the threads to write out a frame, either to its own file or into the stream.
+bool FrameWriter::saveFrame(const QueuedFrame & frame)
+{
+    if (frame.repeatOf >= 0)
+        return saveRepeatedFrame(frame);
+
+    if (stream != 0)
+        return stream->writeFrame(frame.image);
+
+    //Repeated frames may be hard links to this file, so it is replaced rather than written over
+    QFile::remove(frame.fileName);
+
+    if ( (frame.reduceColors)&&(frame.image.format() != QImage::Format_Indexed8) )
+    {
+        QString extension = QFileInfo(frame.fileName).suffix().toLower();
+        if ( (extension == "png")||(extension == "bmp") )
+        {
+            QImage paletteImage = reduceToPalette(frame.image);
+            if (!paletteImage.isNull())
+                return saveImage(paletteImage, frame.fileName, frame.pngCompression);
+        }
+    }
+
+    return saveImage(frame.image, frame.fileName, frame.pngCompression);
+}
+
+
+
+
+
+//This function saves a frame that is the same as an earlier one.  The earlier one may still be being saved by another
+//thread, so it waits for that first.  Then the file is hard linked where the system supports it, as that takes no
+//extra space, and copied otherwise.
+bool FrameWriter::saveRepeatedFrame(const QueuedFrame & frame)
+{
+    if (stream != 0)
+        return stream->repeatFrame();
+
+    waitForFrame(frame.repeatOf);
+    QFile::remove(frame.fileName);
+
+#ifdef Q_OS_UNIX
+    if (::link(QFile::encodeName(frame.sourceFileName).constData(), QFile::encodeName(frame.fileName).constData()) == 0)
+        return true;
+#endif
+    return QFile::copy(frame.sourceFileName, frame.fileName);
+}
+
+
+
+
+
+//This function waits until the frame with the passed sequence number has been saved (or has failed).
+void FrameWriter::waitForFrame(int sequenceNumber)
+{
+    QMutexLocker locker(&mutex);
+
+    while ( (sequenceNumber >= nextInOrder)&&(!finishedEarly.contains(sequenceNumber)) )
+        frameFinished.wait(&mutex);
+}
+
+
+
+
+
+void FrameWriter::frameDone(int sequenceNumber, bool succeeded)
+{
+    QMutexLocker locker(&mutex);
+
+    if (!succeeded)
+        failures++;
+
+    //Move the in-order count forward past this frame and any that finished early waiting for it
+    if (sequenceNumber == nextInOrder)
+    {
+        nextInOrder++;
+        while (finishedEarly.remove(nextInOrder))
+            nextInOrder++;
+    }
+    else
+        finishedEarly.insert(sequenceNumber);
+
+    frameFinished.wakeAll();
+}
+
+
+
+
+
+QString FrameWriter::fileExtension(int outputFormat)
+{
+    switch (outputFormat)
+    {
+    case bmpFormat:
+        return "bmp";
+    case ppmFormat:
+        return "ppm";
+    case webpFormat:
+        return "webp";
+    case rawRgbStreamFormat:
+        return "rgb";
+    case y4mStreamFormat:
+        return "y4m";
+    case packedDeltaFormat:
+        return "antframes";
+    default:
+        return "png";
+    }
+}
+
+
+
+
+
+//WebP is only available if Qt's image format plugins are installed, so this checks with Qt.  The video streams are
+//written by VideoStream, so they are always available.
+bool FrameWriter::formatSupported(int outputFormat)
+{
+    if (isStreamFormat(outputFormat))
+        return true;
+    return QImageWriter::supportedImageFormats().contains(fileExtension(outputFormat).toLatin1());
+}
+
+
+
+
+
+//The stream formats put every frame into one file instead of one file per frame
+bool FrameWriter::isStreamFormat(int outputFormat)
+{
+    return ( (outputFormat == rawRgbStreamFormat)||(outputFormat == y4mStreamFormat)||(outputFormat == packedDeltaFormat) );
+}
+
+//This function returns the VideoStream format that writes one of the stream formats
+int FrameWriter::streamFormat(int outputFormat)
+{
+    if (outputFormat == rawRgbStreamFormat)
+        return VideoStream::rawRgbStream;
+    if (outputFormat == packedDeltaFormat)
+        return VideoStream::packedDeltaStream;
+    return VideoStream::y4mStream;
+}
+
+
+
+
+
+//This function saves an image in the format given by the file name's extension.  For PNG files, the compression can
+//trade file size for speed: most of the time spent saving a PNG is in zlib, and the fast setting is several times
+//quicker than the maximum for files that are only a little bigger.  WebP files are always saved lossless.
+bool FrameWriter::saveImage(const QImage & image, const QString & fileName, int pngCompression)
+{
+    QImageWriter imageWriter(fileName);
+    QString extension = QFileInfo(fileName).suffix().toLower();
+
+    //Qt turns the PNG quality into a zlib level with (100 - quality) * 9 / 91, so 85 is level 1 and 0 is level 9.
+    //Leaving it unset uses zlib's default.
+    if (extension == "png")
+    {
+        if (pngCompression == fastCompression)
+            imageWriter.setQuality(85);
+        if (pngCompression == maximumCompression)
+            imageWriter.setQuality(0);
+    }
+
+    //Qt's WebP writer switches to lossless at a quality of 100
+    if (extension == "webp")
+        imageWriter.setQuality(100);
+
+    return imageWriter.write(image);
+}
+
+
+
+
+
+//This function makes an 8-bit indexed copy of an image that has no more than 256 different colors.  Nothing is lost,
+//so a palette PNG made from it shows exactly the same thing.  If the image has more colors, a null image is returned.
+//Neighbouring pixels are usually the same color, so the last color found is checked before the table is searched.
+QImage FrameWriter::reduceToPalette(const QImage & image)
+{
+    QImage source = image;
+    if ( (source.format() != QImage::Format_RGB32)&&(source.format() != QImage::Format_ARGB32) )
+        source = source.convertToFormat(QImage::Format_RGB32);
+
+    QImage paletteImage(source.size(), QImage::Format_Indexed8);
+    QVector<QRgb> palette;
+
+    //An open addressing hash table from colors to palette entries.  It has twice as many slots as there can be
+    //colors, so it never fills up.
+    const int slotCount = 512;
+    QRgb slotColors[slotCount];
+    int slotIndexes[slotCount];
+    for (int i = 0; i < slotCount; i++)
+        slotIndexes[i] = -1;
+
+    QRgb lastColor = 0;
+    int lastIndex = -1;
+
+    for (int y = 0; y < source.height(); y++)
+    {
+        const QRgb * line = reinterpret_cast<const QRgb *>(source.constScanLine(y));
+        uchar * indexLine = paletteImage.scanLine(y);
+
+        for (int x = 0; x < source.width(); x++)
+        {
+            QRgb color = line[x] | 0xff000000;
+            if ( (color != lastColor)||(lastIndex < 0) )
+            {
+                int slot = int((color * 2654435761u) >> 23);
+                while ( (slotIndexes[slot] >= 0)&&(slotColors[slot] != color) )
+                    slot = (slot + 1) & (slotCount - 1);
+
+                if (slotIndexes[slot] < 0)
+                {
+                    if (palette.size() == 256)
+                        return QImage();
+                    slotColors[slot] = color;
+                    slotIndexes[slot] = palette.size();
+                    palette.append(color);
+                }
+
+                lastColor = color;
+                lastIndex = slotIndexes[slot];
+            }
+            indexLine[x] = uchar(lastIndex);
+        }
+    }
+
+    paletteImage.setColorTable(palette);
+    return paletteImage;
+}
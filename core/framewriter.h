@@ -0,0 +1,105 @@
+#ifndef FRAMEWRITER_H
+#define FRAMEWRITER_H
+
+#include <QImage>
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QSet>
+#include <QVector>
+#include <QThread>
+
+#include "videostream.h"
+#include "framepool.h"
+
+//This class saves images to disk on a set of background threads, so that encoding one frame doesn't hold up making
+//the next.  Frames are handed over with write, which waits if the queue is full so that no more than a fixed number
+//of frames are ever waiting in memory.  Each frame has a sequence number, and the writer keeps track of how many have
+//been finished in order.  The file format comes from the file name's extension.  Alternatively, the frames can all
+//go into one video stream, in which case a single thread writes them in the order they were queued.
+class FrameWriter
+{
+public:
+    //These match the order of the choices in the settings
+    enum OutputFormat {pngFormat = 0, bmpFormat = 1, ppmFormat = 2, webpFormat = 3, rawRgbStreamFormat = 4, y4mStreamFormat = 5,
+                       packedDeltaFormat = 6};
+    enum PngCompression {fastCompression = 0, defaultCompression = 1, maximumCompression = 2};
+
+    static QString fileExtension(int outputFormat);
+    static bool formatSupported(int outputFormat);
+    static bool isStreamFormat(int outputFormat);
+    static int streamFormat(int outputFormat);
+    static bool saveImage(const QImage & image, const QString & fileName, int pngCompression);
+    static QImage reduceToPalette(const QImage & image);
+
+    FrameWriter();
+    ~FrameWriter();
+
+    void start(int threadCount, int queueDepthP, int firstSequenceNumber);
+    void startStream(VideoStream * streamP, int queueDepthP, int firstSequenceNumber);
+    bool write(const QImage & image, const QString & fileName, int sequenceNumber);
+    bool writeRepeat(const QString & fileName, int sequenceNumber);
+    void finish();
+    void cancel();
+    int framesWrittenInOrder();
+    int failedFrameCount();
+    void setPngCompression(int pngCompressionP);
+    void setPaletteReduction(bool enabled);
+    void setFramePool(FramePool * framePoolP);
+
+    //A frame waiting to be saved.  If repeatOf isn't -1, the frame is the same as that earlier one, which was saved
+    //as sourceFileName.
+    struct QueuedFrame
+    {
+        QImage image;
+        QString fileName;
+        int sequenceNumber;
+        int pngCompression;
+        bool reduceColors;
+        int repeatOf;
+        QString sourceFileName;
+    };
+
+    //The threads call these to get work and report back
+    bool takeFrame(QueuedFrame * frame);
+    bool saveFrame(const QueuedFrame & frame);
+    void frameDone(int sequenceNumber, bool succeeded);
+    void releaseImage(QImage & image);
+
+private:
+    QMutex mutex;
+    QWaitCondition frameQueued;
+    QWaitCondition frameTaken;
+    QWaitCondition frameFinished;
+    QQueue<QueuedFrame> queue;
+    int queueDepth;
+    bool stopping;
+    int pngCompression;
+    bool reduceColors;
+
+    QVector<QThread *> threads;
+
+    //The stream frames are written to, or null when they are saved as separate files
+    VideoStream * stream;
+
+    //Where saved frames are handed back to, if anywhere
+    FramePool * framePool;
+
+    //nextInOrder is the first sequence number that hasn't been written yet.  Frames finished ahead of it wait in
+    //finishedEarly until the gap is filled.
+    int firstInOrder;
+    int nextInOrder;
+    QSet<int> finishedEarly;
+    int failures;
+
+    //The last frame queued by write, for writeRepeat
+    QString lastFileName;
+    int lastSequenceNumber;
+
+    void stopThreads();
+    bool saveRepeatedFrame(const QueuedFrame & frame);
+    void waitForFrame(int sequenceNumber);
+};
+
+#endif // FRAMEWRITER_H
@@ -0,0 +1,252 @@
+#include "grid.h"
+#include "workerpool.h"
+
+Grid::Grid(int pixelWidthP, int pixelHeightP, int squareSizeP, QColor fillColor)
+{
+    //Set the data members to the passed parameters.
+    pixelWidth = pixelWidthP;
+    pixelHeight = pixelHeightP;
+    squareSize = squareSizeP;
+
+    //Calculate the number of rows and columns, including any that are partially-visible.  I.e. round
+    //the number of rows and columns up.
+    rowCount = pixelHeight/squareSize;
+    if (pixelHeight%squareSize > 0) //if there is a remainder, add one (serves to round up)
+        rowCount++;
+    columnCount = pixelWidth/squareSize;
+    if (pixelWidth%squareSize > 0) //if there is a remainder, add one (serves to round up)
+        columnCount++;
+
+    //Create the image that will show the grid!
+    gridImage = new QImage(pixelWidth, pixelHeight, QImage::Format_RGB32);
+    gridImage->fill(fillColor);
+    drawCount = 0;
+
+}
+
+
+
+
+Grid::~Grid()
+{
+    delete gridImage;
+}
+
+
+
+
+//This function colors a square to the passed color.  The column and row parameters start at zero, like
+//C++ arrays and like the setPixel functions uses as well.
+void Grid::drawSquare(int column, int row, QColor color)
+{
+    //Quit if the square being drawn isn't visible.  The "or equal to" is required because the column
+    //and row counts start at zero.  For example, if columnCount = 3 and I try to draw to column number
+    //3 (the 4th column), this code will quit.
+    if ( (column < 0)||(row < 0)||(column >= columnCount)||(row >= rowCount) )
+        return;
+
+    int firstPixelColumn = column*squareSize;
+    int lastPixelColumnPlusOne = firstPixelColumn+squareSize;
+
+    int firstPixelRow = row*squareSize;
+    int lastPixelRowPlusOne = firstPixelRow+squareSize;
+
+    //If either of the lastPlusOne variables is greater than the corresponding dimension of the image,
+    //change them to stay within the image.  This should keep us from trying to draw pixels that are outside
+    //the image and make it possible to draw partial squares.
+    if (lastPixelColumnPlusOne>pixelWidth)
+        lastPixelColumnPlusOne=pixelWidth;
+    if (lastPixelRowPlusOne>pixelHeight)
+        lastPixelRowPlusOne=pixelHeight;
+
+    drawCount++;
+
+    for (int i=firstPixelColumn; i<lastPixelColumnPlusOne; i++)
+    {
+        for (int j=firstPixelRow; j<lastPixelRowPlusOne; j++)
+        {
+            gridImage->setPixel(i, j, color.rgb() );
+        }
+    }
+}
+
+
+
+//This function is for when the pixel size of the image is changed.  It just deletes the image and then
+//does exactly what the constructor does to start from scratch.
+void Grid::changeImageSize(int pixelWidthP, int pixelHeightP, int squareSizeP, QColor fillColor)
+{
+    delete gridImage;
+
+    //Set the data members to the passed parameters.
+    pixelWidth = pixelWidthP;
+    pixelHeight = pixelHeightP;
+    squareSize = squareSizeP;
+
+    //Calculate the number of rows and columns, including any that are partially-visible.  I.e. round
+    //the number of rows and columns up.
+    rowCount = pixelHeight/squareSize;
+    if (pixelHeight%squareSize > 0) //if there is a remainder, add one (serves to round up)
+        rowCount++;
+    columnCount = pixelWidth/squareSize;
+    if (pixelWidth%squareSize > 0) //if there is a remainder, add one (serves to round up)
+        columnCount++;
+
+    //Create the image that will show the grid!
+    gridImage = new QImage(pixelWidth, pixelHeight, QImage::Format_RGB32);
+    gridImage->fill(fillColor);
+
+}
+
+
+//If only the square size is changed, then it is necessary to delete and recreate the image.
+void Grid::changeSquareSize(int squareSizeP, QColor fillColor)
+{
+    squareSize = squareSizeP;
+
+    //Calculate the number of rows and columns, including any that are partially-visible.  I.e. round
+    //the number of rows and columns up.
+    rowCount = pixelHeight/squareSize;
+    if (pixelHeight%squareSize > 0) //if there is a remainder, add one (serves to round up)
+        rowCount++;
+    columnCount = pixelWidth/squareSize;
+    if (pixelWidth%squareSize > 0) //if there is a remainder, add one (serves to round up)
+        columnCount++;
+
+    //Redraw the image
+    gridImage->fill(fillColor);
+
+}
+
+
+
+
+
+void Grid::fillImage(QColor fillColor)
+{
+    //Redraw the image
+    gridImage->fill(fillColor);
+    drawCount++;
+}
+
+
+
+
+
+//This function redraws every square from a 2D state array, coloring each with palette[state].  offset is added to
+//the column and row before looking them up, to skip over any buffer around the visible part of the array.  The image
+//is filled a row of pixels at a time, in bands that are shared out between the worker threads.
+void Grid::drawStates(int ** state, int offset, const QVector<QRgb> & palette)
+{
+    //Get the pixel data here, before the threads start, so the image is only detached once
+    uchar * imageBits = gridImage->bits();
+    int bytesPerLine = gridImage->bytesPerLine();
+    const QRgb * colors = palette.constData();
+    drawCount++;
+
+    WorkerPool::runInBands(pixelHeight, [=](int firstRow, int lastRow)
+    {
+        for (int y = firstRow; y <= lastRow; y++)
+        {
+            QRgb * line = reinterpret_cast<QRgb *>(imageBits + y * bytesPerLine);
+            int row = y / squareSize + offset;
+
+            for (int column = 0; column < columnCount; column++)
+            {
+                QRgb color = colors[ state[column + offset][row] ];
+                int firstPixel = column * squareSize;
+                int lastPixelPlusOne = qMin(firstPixel + squareSize, pixelWidth);
+                for (int x = firstPixel; x < lastPixelPlusOne; x++)
+                    line[x] = color;
+            }
+        }
+    });
+}
+
+
+
+
+
+//This version of drawStates has separate column and row offsets, and can be given any part of the state array or
+//beyond it.  Cells outside of the array (stateColumns by stateRows) are drawn in the state 0 color.
+void Grid::drawStates(int ** state, int columnOffset, int rowOffset, int stateColumns, int stateRows, const QVector<QRgb> & palette)
+{
+    uchar * imageBits = gridImage->bits();
+    int bytesPerLine = gridImage->bytesPerLine();
+    const QRgb * colors = palette.constData();
+    drawCount++;
+
+    WorkerPool::runInBands(pixelHeight, [=](int firstRow, int lastRow)
+    {
+        for (int y = firstRow; y <= lastRow; y++)
+        {
+            QRgb * line = reinterpret_cast<QRgb *>(imageBits + y * bytesPerLine);
+            int row = y / squareSize + rowOffset;
+            bool rowInArray = ( (row >= 0)&&(row < stateRows) );
+
+            for (int column = 0; column < columnCount; column++)
+            {
+                int stateColumn = column + columnOffset;
+                QRgb color = colors[0];
+                if ( (rowInArray)&&(stateColumn >= 0)&&(stateColumn < stateColumns) )
+                    color = colors[ state[stateColumn][row] ];
+
+                int firstPixel = column * squareSize;
+                int lastPixelPlusOne = qMin(firstPixel + squareSize, pixelWidth);
+                for (int x = firstPixel; x < lastPixelPlusOne; x++)
+                    line[x] = color;
+            }
+        }
+    });
+}
+
+
+
+
+
+//This function is like drawStates, but fills an 8-bit indexed image the same size as the grid image with the states
+//themselves.  The target's color table gives the colors.
+void Grid::drawStatesIndexed(int ** state, int offset, QImage * target)
+{
+    uchar * imageBits = target->bits();
+    int bytesPerLine = target->bytesPerLine();
+
+    WorkerPool::runInBands(pixelHeight, [=](int firstRow, int lastRow)
+    {
+        for (int y = firstRow; y <= lastRow; y++)
+        {
+            uchar * line = imageBits + y * bytesPerLine;
+            int row = y / squareSize + offset;
+
+            for (int column = 0; column < columnCount; column++)
+            {
+                uchar index = uchar(state[column + offset][row]);
+                int firstPixel = column * squareSize;
+                int lastPixelPlusOne = qMin(firstPixel + squareSize, pixelWidth);
+                for (int x = firstPixel; x < lastPixelPlusOne; x++)
+                    line[x] = index;
+            }
+        }
+    });
+}
+
+
+
+
+
+//This function is drawSquare for an 8-bit indexed image made by drawStatesIndexed.
+void Grid::drawIndexedSquare(QImage * target, int column, int row, int index)
+{
+    if ( (column < 0)||(row < 0)||(column >= columnCount)||(row >= rowCount) )
+        return;
+
+    int lastPixelColumnPlusOne = qMin(column * squareSize + squareSize, pixelWidth);
+    int lastPixelRowPlusOne = qMin(row * squareSize + squareSize, pixelHeight);
+
+    for (int j = row * squareSize; j < lastPixelRowPlusOne; j++)
+    {
+        uchar * line = target->scanLine(j);
+        for (int i = column * squareSize; i < lastPixelColumnPlusOne; i++)
+            line[i] = uchar(index);
+    }
+}
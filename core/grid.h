@@ -1,27 +1,34 @@
-#ifndef GRID_H
-#define GRID_H
-
-#include <QtWidgets>
-
-class Grid
-{
-public:
-    Grid(int pixelWidthP, int pixelHeightP, int squareSizeP, QColor fillColor);
-    ~Grid();
-
-    QImage * gridImage;
-    void drawSquare(int column, int row, QColor color);
-    void changeImageSize(int pixelWidthP, int pixelHeightP, int squareSizeP, QColor fillColor);
-    void changeSquareSize(int squareSizeP, QColor fillColor);
-    void fillImage(QColor fillColor);
-    int rowCount;
-    int columnCount;
-
-private:
-    int pixelWidth;
-    int pixelHeight;
-    int squareSize;
-
-};
-
-#endif // GRID_H
+#ifndef GRID_H
+#define GRID_H
+
+#include <QtGui>
+
+class Grid
+{
+public:
+    Grid(int pixelWidthP, int pixelHeightP, int squareSizeP, QColor fillColor);
+    ~Grid();
+
+    QImage * gridImage;
+    void drawSquare(int column, int row, QColor color);
+    void changeImageSize(int pixelWidthP, int pixelHeightP, int squareSizeP, QColor fillColor);
+    void changeSquareSize(int squareSizeP, QColor fillColor);
+    void fillImage(QColor fillColor);
+    void drawStates(int ** state, int offset, const QVector<QRgb> & palette);
+    void drawStates(int ** state, int columnOffset, int rowOffset, int stateColumns, int stateRows, const QVector<QRgb> & palette);
+    void drawStatesIndexed(int ** state, int offset, QImage * target);
+    void drawIndexedSquare(QImage * target, int column, int row, int index);
+    int rowCount;
+    int columnCount;
+
+    //This goes up every time something is drawn on the image, so callers can tell whether it has changed
+    quint32 drawCount;
+
+private:
+    int pixelWidth;
+    int pixelHeight;
+    int squareSize;
+
+};
+
+#endif // GRID_H
@@ -0,0 +1,277 @@
+#include "gridpyramid.h"
+#include "workerpool.h"
+#include <cmath>
+#include <cstring>
+
+GridPyramid::GridPyramid(int ** stateP, int columnCountP, int rowCountP, int stateCountP)
+{
+    //Store the state array that this pyramid summarises, along with its size
+    state = stateP;
+    columnCount = columnCountP;
+    rowCount = rowCountP;
+    stateCount = 0;
+
+    levelCount = 0;
+    levelCounts = 0;
+    levelWidths = 0;
+    levelHeights = 0;
+
+    rebuild(stateCountP);
+}
+
+
+
+
+
+GridPyramid::~GridPyramid()
+{
+    deleteLevels();
+}
+
+
+
+
+
+void GridPyramid::deleteLevels()
+{
+    for (int k = 0; k < levelCount; k++)
+        delete [] levelCounts[k];
+    delete [] levelCounts;
+    delete [] levelWidths;
+    delete [] levelHeights;
+
+    levelCount = 0;
+    levelCounts = 0;
+    levelWidths = 0;
+    levelHeights = 0;
+}
+
+
+
+
+
+//This function recalculates every level from the state array.  It is needed when the pyramid is first made and
+//whenever the grid is changed other than by the ant (e.g. when it is reset).
+void GridPyramid::rebuild(int stateCountP)
+{
+    //If the number of states has changed, the histograms are a different size, so start over
+    if (stateCountP != stateCount)
+        deleteLevels();
+    stateCount = stateCountP;
+
+    //Make the levels if they don't exist yet.  Each level has half the blocks of the one below it (rounded up), and
+    //the last level is a single block.
+    if (levelCount == 0)
+    {
+        int width = columnCount;
+        int height = rowCount;
+        while ( (width > 1)||(height > 1) )
+        {
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+            levelCount++;
+        }
+
+        levelCounts = new quint32 * [levelCount];
+        levelWidths = new int [levelCount];
+        levelHeights = new int [levelCount];
+
+        width = columnCount;
+        height = rowCount;
+        for (int k = 0; k < levelCount; k++)
+        {
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+            levelWidths[k] = width;
+            levelHeights[k] = height;
+            levelCounts[k] = new quint32 [width * height * stateCount];
+        }
+    }
+
+    //Fill in the first level from the cells.  Blocks on the right and bottom edges may be only partly covered by
+    //the grid, which is fine because they just end up with smaller totals.
+    if (levelCount == 0)
+        return;
+    memset(levelCounts[0], 0, sizeof(quint32) * levelWidths[0] * levelHeights[0] * stateCount);
+    for (int i = 0; i < columnCount; i++)
+    {
+        for (int j = 0; j < rowCount; j++)
+            levelCounts[0][((j >> 1) * levelWidths[0] + (i >> 1)) * stateCount + state[i][j]]++;
+    }
+
+    //Each level above is the sum of the four blocks below it
+    for (int k = 1; k < levelCount; k++)
+    {
+        memset(levelCounts[k], 0, sizeof(quint32) * levelWidths[k] * levelHeights[k] * stateCount);
+        for (int y = 0; y < levelHeights[k-1]; y++)
+        {
+            for (int x = 0; x < levelWidths[k-1]; x++)
+            {
+                quint32 * source = levelCounts[k-1] + (y * levelWidths[k-1] + x) * stateCount;
+                quint32 * destination = levelCounts[k] + ((y >> 1) * levelWidths[k] + (x >> 1)) * stateCount;
+                for (int s = 0; s < stateCount; s++)
+                    destination[s] += source[s];
+            }
+        }
+    }
+}
+
+
+
+
+
+//This function draws part of the grid into the target image.  firstColumn and firstRow give the grid position of the
+//image's top-left corner, and cellsPerPixel is the zoom: values above 1 mean each pixel covers more than one cell.  The
+//level used is the one whose blocks are just smaller than a pixel, so the work done depends on the number of pixels,
+//not the number of cells.  Pixels outside the grid are drawn in the state 0 color.
+void GridPyramid::render(QImage * target, double firstColumn, double firstRow, double cellsPerPixel, const QVector<QRgb> & palette)
+{
+    int pixelWidth = target->width();
+    int pixelHeight = target->height();
+
+    //Choose the level: level k has blocks of 2^k cells, and we want the largest block that fits in one pixel.
+    int level = 0;
+    while ( (level < levelCount)&&(double(2 << level) <= cellsPerPixel) )
+        level++;
+
+    //Work out which range of blocks each column of pixels covers, so it doesn't have to be done for every pixel.
+    int levelWidth = columnCount;
+    int levelHeight = rowCount;
+    if (level > 0)
+    {
+        levelWidth = levelWidths[level-1];
+        levelHeight = levelHeights[level-1];
+    }
+    int * firstBlockX = new int [pixelWidth];
+    int * lastBlockX = new int [pixelWidth];
+    for (int px = 0; px < pixelWidth; px++)
+    {
+        if (level == 0)
+        {
+            //At full resolution, each pixel just shows the cell under its center
+            firstBlockX[px] = int(floor(firstColumn + (px + 0.5) * cellsPerPixel));
+            lastBlockX[px] = firstBlockX[px];
+        }
+        else
+        {
+            firstBlockX[px] = int(floor(firstColumn + px * cellsPerPixel)) >> level;
+            lastBlockX[px] = (int(ceil(firstColumn + (px + 1) * cellsPerPixel)) - 1) >> level;
+        }
+
+        //Pixels that miss the grid entirely are marked by making the range empty
+        if ( (lastBlockX[px] < 0)||(firstBlockX[px] >= levelWidth) )
+        {
+            firstBlockX[px] = 1;
+            lastBlockX[px] = 0;
+        }
+        if (firstBlockX[px] < 0)
+            firstBlockX[px] = 0;
+        if (lastBlockX[px] >= levelWidth)
+            lastBlockX[px] = levelWidth - 1;
+    }
+
+    //The rows of pixels are independent of each other, so they are drawn in bands on the worker threads.  Each
+    //band has its own space for adding up histograms.
+    uchar * targetBits = target->bits();
+    int bytesPerLine = target->bytesPerLine();
+    WorkerPool::runInBands(pixelHeight, [&](int firstPixelRow, int lastPixelRow)
+    {
+        renderRows(targetBits, bytesPerLine, pixelWidth, firstPixelRow, lastPixelRow, level, firstBlockX, lastBlockX,
+                   firstRow, cellsPerPixel, palette);
+    });
+
+    delete [] firstBlockX;
+    delete [] lastBlockX;
+}
+
+
+
+
+
+//This function draws rows firstPixelRow to lastPixelRow for render, which has already chosen the level and worked
+//out the blocks under each column of pixels.
+void GridPyramid::renderRows(uchar * targetBits, int bytesPerLine, int pixelWidth, int firstPixelRow, int lastPixelRow, int level,
+                             const int * firstBlockX, const int * lastBlockX, double firstRow, double cellsPerPixel,
+                             const QVector<QRgb> & palette)
+{
+    int levelWidth = columnCount;
+    int levelHeight = rowCount;
+    if (level > 0)
+    {
+        levelWidth = levelWidths[level-1];
+        levelHeight = levelHeights[level-1];
+    }
+
+    quint64 * totals = new quint64 [stateCount];
+    QRgb background = palette[0];
+
+    for (int py = firstPixelRow; py <= lastPixelRow; py++)
+    {
+        QRgb * line = reinterpret_cast<QRgb *>(targetBits + py * bytesPerLine);
+
+        int firstBlockY, lastBlockY;
+        if (level == 0)
+        {
+            firstBlockY = int(floor(firstRow + (py + 0.5) * cellsPerPixel));
+            lastBlockY = firstBlockY;
+        }
+        else
+        {
+            firstBlockY = int(floor(firstRow + py * cellsPerPixel)) >> level;
+            lastBlockY = (int(ceil(firstRow + (py + 1) * cellsPerPixel)) - 1) >> level;
+        }
+        if ( (lastBlockY < 0)||(firstBlockY >= levelHeight) )
+        {
+            firstBlockY = 1;
+            lastBlockY = 0;
+        }
+        if (firstBlockY < 0)
+            firstBlockY = 0;
+        if (lastBlockY >= levelHeight)
+            lastBlockY = levelHeight - 1;
+
+        for (int px = 0; px < pixelWidth; px++)
+        {
+            //Pixels entirely outside of the grid
+            if ( (firstBlockX[px] > lastBlockX[px])||(firstBlockY > lastBlockY) )
+            {
+                line[px] = background;
+                continue;
+            }
+
+            if (level == 0)
+            {
+                line[px] = palette[ state[firstBlockX[px]][firstBlockY] ];
+                continue;
+            }
+
+            //Add up the histograms of the blocks under this pixel and use them to average the state colors
+            for (int s = 0; s < stateCount; s++)
+                totals[s] = 0;
+            for (int y = firstBlockY; y <= lastBlockY; y++)
+            {
+                for (int x = firstBlockX[px]; x <= lastBlockX[px]; x++)
+                {
+                    quint32 * block = levelCounts[level-1] + (y * levelWidth + x) * stateCount;
+                    for (int s = 0; s < stateCount; s++)
+                        totals[s] += block[s];
+                }
+            }
+
+            quint64 red = 0, green = 0, blue = 0, cellTotal = 0;
+            for (int s = 0; s < stateCount; s++)
+            {
+                red += totals[s] * qRed(palette[s]);
+                green += totals[s] * qGreen(palette[s]);
+                blue += totals[s] * qBlue(palette[s]);
+                cellTotal += totals[s];
+            }
+            if (cellTotal == 0)
+                line[px] = background;
+            else
+                line[px] = qRgb(int((red + cellTotal/2) / cellTotal), int((green + cellTotal/2) / cellTotal), int((blue + cellTotal/2) / cellTotal));
+        }
+    }
+
+    delete [] totals;
+}
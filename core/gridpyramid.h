@@ -0,0 +1,56 @@
+#ifndef GRIDPYRAMID_H
+#define GRIDPYRAMID_H
+
+#include <QImage>
+#include <QVector>
+
+//This class holds a multi-resolution summary of an AntGrid's states, so that a grid far bigger than the screen can be
+//drawn zoomed out without looking at every cell.  Level 1 stores a histogram of states for every 2x2 block of cells,
+//level 2 for every 4x4 block, and so on until one block covers the whole grid.  (Level 0 is the state array itself.)
+//The histograms are kept up to date one cell at a time as the ant changes them.
+class GridPyramid
+{
+public:
+    GridPyramid(int ** stateP, int columnCountP, int rowCountP, int stateCountP);
+    ~GridPyramid();
+
+    void rebuild(int stateCountP);
+    void changeCell(int column, int row, int oldState, int newState);
+    void render(QImage * target, double firstColumn, double firstRow, double cellsPerPixel, const QVector<QRgb> & palette);
+
+private:
+    int ** state;
+    int columnCount;
+    int rowCount;
+    int stateCount;
+
+    //levelCounts[k] holds the histograms for level k+1: stateCount counts for each block, blocks stored row by row.
+    int levelCount;
+    quint32 ** levelCounts;
+    int * levelWidths;
+    int * levelHeights;
+
+    void deleteLevels();
+    void renderRows(uchar * targetBits, int bytesPerLine, int pixelWidth, int firstPixelRow, int lastPixelRow, int level,
+                    const int * firstBlockX, const int * lastBlockX, double firstRow, double cellsPerPixel,
+                    const QVector<QRgb> & palette);
+};
+
+
+
+
+
+//This is called for every step of the ant, so it is defined here to let the compiler inline it.
+inline void GridPyramid::changeCell(int column, int row, int oldState, int newState)
+{
+    for (int k = 0; k < levelCount; k++)
+    {
+        column >>= 1;
+        row >>= 1;
+        quint32 * block = levelCounts[k] + (row * levelWidths[k] + column) * stateCount;
+        block[oldState]--;
+        block[newState]++;
+    }
+}
+
+#endif // GRIDPYRAMID_H
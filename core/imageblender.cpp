@@ -0,0 +1,298 @@
+#include "imageblender.h"
+#include "blendkernels.h"
+#include "workerpool.h"
+#include <QtGui>
+#include <cstring>
+
+ImageBlender::ImageBlender()
+{
+    //Set initialized to false so the image blender won't work until it is initialized
+    initialized = false;
+
+    accumulate = false;
+    cancelRequested = 0;
+    arrayToBlend = 0;
+    channelSums = 0;
+    channelSumsPixelCount = 0;
+    samplesAdded = 0;
+    sampleMismatch = false;
+    framePool = 0;
+}
+
+
+
+
+
+ImageBlender::~ImageBlender()
+{
+    deleteBuffers();
+}
+
+
+
+
+
+void ImageBlender::deleteBuffers()
+{
+    delete [] arrayToBlend;
+    arrayToBlend = 0;
+
+    delete [] channelSums;
+    channelSums = 0;
+    channelSumsPixelCount = 0;
+}
+
+
+
+
+
+//This function gets the image blender ready to blend arraySizeP images per frame.  If accumulateP is true, the images
+//are summed as they are added instead of being stored.
+void ImageBlender::initialize(int arraySizeP, bool accumulateP)
+{
+    //If the image blender has been previously initialized, delete its buffers now
+    deleteBuffers();
+    initialized = false;
+
+    //Store arguments in data members
+    arraySize = arraySizeP;
+    accumulate = accumulateP;
+    samplesAdded = 0;
+    sampleMismatch = false;
+    cancelRequested = 0;
+
+    //check to make sure arraySize is a valid number
+    if (arraySize < 1)
+        return;
+
+    //Create the image array.  In accumulate mode, the sums are created when the first image arrives and its size is
+    //known.
+    if (!accumulate)
+        arrayToBlend = new QImage [arraySize];
+
+    //Label the image blender as initialized - allows it to work.
+    initialized = true;
+}
+
+
+
+
+
+void ImageBlender::addImage(const QImage & imageToAdd, int i)
+{
+    if (accumulate)
+    {
+        accumulateImage(imageToAdd);
+        return;
+    }
+
+    //Copy the pixels into the image kept for this sample instead of keeping a reference to the caller's image.  A
+    //reference would make the caller's next change to its image (the next square drawn on the grid, say) copy the
+    //whole image into newly allocated memory.
+    QImage & storedImage = arrayToBlend[i];
+    if ( (storedImage.size() == imageToAdd.size())&&(storedImage.format() == imageToAdd.format())&&
+         (storedImage.bytesPerLine() == imageToAdd.bytesPerLine())&&(storedImage.isDetached()) )
+        memcpy(storedImage.bits(), imageToAdd.constBits(), imageToAdd.sizeInBytes());
+    else
+        storedImage = imageToAdd.copy();
+}
+
+
+
+
+
+//This function adds each channel of each pixel of the passed image to the running totals.
+void ImageBlender::accumulateImage(const QImage & imageToAdd)
+{
+    if (!initialized)
+        return;
+
+    //The first image of a frame sets the size that the rest have to match
+    if (samplesAdded == 0)
+    {
+        imageSize = imageToAdd.size();
+        sampleMismatch = false;
+
+        int pixelCount = imageSize.width() * imageSize.height();
+        if (pixelCount != channelSumsPixelCount)
+        {
+            delete [] channelSums;
+            channelSums = new quint32 [pixelCount * 4];
+            channelSumsPixelCount = pixelCount;
+        }
+        memset(channelSums, 0, sizeof(quint32) * 4 * channelSumsPixelCount);
+    }
+
+    samplesAdded++;
+
+    //If there is a size or format discrepancy, the frame can't be blended
+    if ( (imageToAdd.size() != imageSize)||(imageToAdd.format() != QImage::Format_RGB32) )
+        sampleMismatch = true;
+    if (sampleMismatch)
+        return;
+
+    //Add up the four bytes of every pixel.  Working on the bytes directly (rather than red, green and blue) lets
+    //whole rows be handled by the SIMD kernels.  The fourth byte is always 255 in an RGB32 image, so its average comes
+    //out as 255 too.
+    int rowBytes = imageSize.width() * 4;
+    const uchar * imageBits = imageToAdd.constBits();
+    int bytesPerLine = imageToAdd.bytesPerLine();
+    quint32 * sums = channelSums;
+    WorkerPool::runInBands(imageSize.height(), [=](int firstRow, int lastRow)
+    {
+        for (int j = firstRow; j <= lastRow; j++)
+            BlendKernels::addBytes(imageBits + j * bytesPerLine, sums + j * rowBytes, rowBytes);
+    }, &cancelRequested);
+}
+
+
+
+
+
+QImage ImageBlender::blendImages()
+{
+    //Quit with a null image if the image blender hasn't been initialized
+    if (!initialized)
+        return QImage();
+
+    if (accumulate)
+        return blendAccumulatedImages();
+    else
+        return blendStoredImages();
+}
+
+
+
+
+
+//This function turns the running totals into the blended image by dividing each of them by the number of samples.
+//The totals are cleared when the first image of the next frame is added.
+QImage ImageBlender::blendAccumulatedImages()
+{
+    int sampleCount = samplesAdded;
+    samplesAdded = 0;
+
+    //Quit with a null image if there were no images, if they didn't match or if either the height or width is zero
+    if ( (sampleCount == 0)||(sampleMismatch)||(imageSize.isEmpty()) )
+        return QImage();
+
+    //Get an image to hold the blend
+    QImage blendedImage = makeBlendedImage();
+
+    //Each channel is rounded to the nearest integer, the same as the stored mode does.  The rows are split between
+    //the worker threads.
+    int rowBytes = imageSize.width() * 4;
+    uchar * blendedBits = blendedImage.bits();
+    int bytesPerLine = blendedImage.bytesPerLine();
+    const quint32 * sums = channelSums;
+    bool finished = WorkerPool::runInBands(imageSize.height(), [=](int firstRow, int lastRow)
+    {
+        for (int j = firstRow; j <= lastRow; j++)
+            BlendKernels::divideSums(sums + j * rowBytes, blendedBits + j * bytesPerLine, rowBytes, sampleCount);
+    }, &cancelRequested);
+
+    //Quit with a null image if the blending was cancelled
+    if (!finished)
+        return QImage();
+
+    return blendedImage;
+}
+
+
+
+
+
+//This function averages the images stored in arrayToBlend.
+QImage ImageBlender::blendStoredImages()
+{
+    //Note the size of the first image in the array
+    imageSize = arrayToBlend[0].size();
+
+    //Quit with a null image if either the height or width is zero
+    if (imageSize.isEmpty())
+        return QImage();
+
+    //loop through each image in the array to check its size
+    for (int i = 0; i < arraySize; i++)
+    {
+        //If there is a size discrepancy, return a null image
+        if ( !(arrayToBlend[i].size() == imageSize) )
+            return QImage();
+
+        //If any image has a format other than QImage::Format_RGB32, return a null image
+        if ( !(arrayToBlend[i].format() == QImage::Format_RGB32) )
+            return QImage();
+    }
+
+    //If the code got to here, everything should be okay and the blending can now begin.
+
+    //Get an image to hold the blend
+    QImage blendedImage = makeBlendedImage();
+
+    //The images are added up one row at a time, byte by byte, which walks through memory in order and lets the SIMD
+    //kernels do the work.  The result is exactly what averaging the red, green and blue values of each pixel with
+    //doubles and rounding gives.  The rows are split into bands for the worker threads, each with its own totals.
+    int rowBytes = imageSize.width() * 4;
+    uchar * blendedBits = blendedImage.bits();
+    int bytesPerLine = blendedImage.bytesPerLine();
+    const QImage * images = arrayToBlend;
+    int imageCount = arraySize;
+    bool finished = WorkerPool::runInBands(imageSize.height(), [=](int firstRow, int lastRow)
+    {
+        quint32 * rowSums = new quint32 [rowBytes];
+        for (int j = firstRow; j <= lastRow; j++)
+        {
+            memset(rowSums, 0, sizeof(quint32) * rowBytes);
+            for (int k = 0; k < imageCount; k++)
+                BlendKernels::addBytes(images[k].constScanLine(j), rowSums, rowBytes);
+            BlendKernels::divideSums(rowSums, blendedBits + j * bytesPerLine, rowBytes, imageCount);
+        }
+        delete [] rowSums;
+    }, &cancelRequested);
+
+    //Quit with a null image if the blending was cancelled
+    if (!finished)
+        return QImage();
+
+    return blendedImage;
+}
+
+
+
+
+
+//This function returns an image for blendImages to fill, from the frame pool if there is one and it has images of
+//the right size.
+QImage ImageBlender::makeBlendedImage()
+{
+    QImage blendedImage;
+    if (framePool != 0)
+        blendedImage = framePool->lease();
+
+    if ( (blendedImage.size() != imageSize)||(blendedImage.format() != QImage::Format_RGB32) )
+        blendedImage = QImage(imageSize, QImage::Format_RGB32);
+
+    return blendedImage;
+}
+
+
+
+
+
+//This function sets the pool that blended images are leased from.  Whoever ends up with them should release them
+//back to the pool once they are done.
+void ImageBlender::setFramePool(FramePool * framePoolP)
+{
+    framePool = framePoolP;
+}
+
+
+
+
+
+//This function stops a blend that is in progress (blendImages will return a null image) and any that are started
+//before the blender is next initialized.  It is safe to call from any thread.
+void ImageBlender::cancel()
+{
+    cancelRequested = 1;
+}
@@ -0,0 +1,48 @@
+#ifndef IMAGEBLENDER_H
+#define IMAGEBLENDER_H
+
+#include <QImage>
+#include <QAtomicInt>
+
+#include "framepool.h"
+
+class ImageBlender
+{
+public:
+    ImageBlender();
+    ~ImageBlender();
+    void initialize(int arraySizeP, bool accumulateP);
+    void addImage(const QImage & imageToAdd, int i);
+    QImage blendImages();
+    void cancel();
+    void setFramePool(FramePool * framePoolP);
+
+    QImage * arrayToBlend;
+
+private:
+    int arraySize;
+    QSize imageSize;
+    bool initialized;
+
+    //Where the blended images come from, if anywhere.  Without a pool each one is newly allocated.
+    FramePool * framePool;
+
+    //Set by cancel, which may be called from another thread.  The blending stops at the next band of rows.
+    QAtomicInt cancelRequested;
+
+    //In accumulate mode, the images aren't stored.  Instead, each one is added to a running total for every channel
+    //of every pixel as it arrives, so only one frame's worth of memory is needed no matter how many samples there are.
+    bool accumulate;
+    quint32 * channelSums;
+    int channelSumsPixelCount;
+    int samplesAdded;
+    bool sampleMismatch;
+
+    void accumulateImage(const QImage & imageToAdd);
+    QImage blendAccumulatedImages();
+    QImage blendStoredImages();
+    void deleteBuffers();
+    QImage makeBlendedImage();
+};
+
+#endif // IMAGEBLENDER_H
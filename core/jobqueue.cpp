@@ -0,0 +1,244 @@
+#include "jobqueue.h"
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QThread>
+
+JobQueue::JobQueue()
+{
+    //By default, use all of the cores and up to 4 GB
+    memoryBudget = qint64(4096) * 1024 * 1024;
+    coreBudget = QThread::idealThreadCount();
+    running = false;
+}
+
+
+
+
+
+JobQueue::~JobQueue()
+{
+    stop();
+    qDeleteAll(jobs);
+}
+
+
+
+
+
+void JobQueue::setBudget(qint64 memoryBudgetP, int coreBudgetP)
+{
+    memoryBudget = memoryBudgetP;
+    coreBudget = qMax(1, coreBudgetP);
+}
+
+
+
+
+
+//This function adds a job to the end of the queue.  Its settings are read straight away to work out what it needs; if
+//they can't be, it is added as failed.
+RenderJob * JobQueue::addJob(const QString & settingsFile, const QString & outputPath)
+{
+    RenderJob * job = new RenderJob(settingsFile, outputPath);
+    job->prepare();
+    jobs.append(job);
+    return job;
+}
+
+
+
+
+
+void JobQueue::removeJob(int index)
+{
+    if ( (index < 0)||(index >= jobs.size()) )
+        return;
+
+    jobs[index]->stop();
+    delete jobs[index];
+    jobs.remove(index);
+}
+
+
+
+
+
+//This function checks on the running jobs and starts as many waiting ones as the budget allows.  It returns true if
+//any job has changed, other than in the number of frames done.
+bool JobQueue::update()
+{
+    bool changed = false;
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i]->update())
+            changed = true;
+    }
+
+    if (!running)
+        return changed;
+
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i]->status != RenderJob::waitingJob)
+            continue;
+
+        //Stop at the first job that doesn't fit, unless nothing is running, as then it never would
+        bool fits = ( (memoryInUse() + jobs[i]->memoryNeeded <= memoryBudget)&&(coresInUse() + jobs[i]->coresNeeded <= coreBudget) );
+        if ( (!fits)&&(jobCount(RenderJob::runningJob) > 0) )
+            break;
+
+        jobs[i]->start();
+        changed = true;
+    }
+
+    return changed;
+}
+
+
+
+
+
+//This function lets update start jobs.  Failed jobs are given another go.
+void JobQueue::start()
+{
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i]->status == RenderJob::failedJob)
+            jobs[i]->status = RenderJob::waitingJob;
+    }
+    running = true;
+}
+
+
+
+
+
+//This function stops all of the running jobs.  They go back to waiting, and carry on from where they got to when the
+//queue is started again.
+void JobQueue::stop()
+{
+    for (int i = 0; i < jobs.size(); i++)
+        jobs[i]->stop();
+    running = false;
+}
+
+
+
+
+
+//This function says whether the queue is starting jobs, even if none are running at the moment
+bool JobQueue::isRunning()
+{
+    return running;
+}
+
+
+
+
+
+//This function says whether there is nothing left for the queue to do
+bool JobQueue::isFinished()
+{
+    return ( (jobCount(RenderJob::waitingJob) == 0)&&(jobCount(RenderJob::runningJob) == 0) );
+}
+
+
+
+
+
+qint64 JobQueue::memoryInUse()
+{
+    qint64 memory = 0;
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i]->status == RenderJob::runningJob)
+            memory += jobs[i]->memoryNeeded;
+    }
+    return memory;
+}
+
+
+
+
+
+int JobQueue::coresInUse()
+{
+    int cores = 0;
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i]->status == RenderJob::runningJob)
+            cores += jobs[i]->coresNeeded;
+    }
+    return cores;
+}
+
+
+
+
+
+int JobQueue::jobCount(RenderJob::Status status)
+{
+    int count = 0;
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        if (jobs[i]->status == status)
+            count++;
+    }
+    return count;
+}
+
+
+
+
+
+//This function saves the queue to a file, one job per line: the status, the number of frames done, the settings file
+//and the output path, separated by tabs.
+bool JobQueue::saveState(const QString & fileName)
+{
+    QFile saveFile(fileName);
+    if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream outputStream(&saveFile);
+    for (int i = 0; i < jobs.size(); i++)
+    {
+        outputStream << RenderJob::statusName(jobs[i]->status) << "\t" << jobs[i]->framesDone << "\t"
+                     << jobs[i]->settingsFile << "\t" << jobs[i]->outputPath << Qt::endl;
+    }
+    return true;
+}
+
+
+
+
+
+//This function replaces the jobs with those saved in a file by saveState.  Jobs that were running when it was saved
+//are waiting again, and will carry on from the frames they had done.
+bool JobQueue::loadState(const QString & fileName)
+{
+    QFile loadFile(fileName);
+    if (!loadFile.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+
+    stop();
+    qDeleteAll(jobs);
+    jobs.clear();
+
+    QTextStream inputStream(&loadFile);
+    while (!inputStream.atEnd())
+    {
+        QStringList fields = inputStream.readLine().split("\t");
+        if (fields.size() != 4)
+            continue;
+
+        RenderJob * job = addJob(fields[2], fields[3]);
+        if (job->status == RenderJob::failedJob)
+            continue;
+        job->status = RenderJob::statusFromName(fields[0]);
+        if (job->status == RenderJob::runningJob)
+            job->status = RenderJob::waitingJob;
+        job->framesDone = fields[1].toInt();
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#ifndef JOBQUEUE_H
+#define JOBQUEUE_H
+
+#include <QString>
+#include <QVector>
+
+#include "renderjob.h"
+
+//This class renders a list of jobs, running as many at once as its memory and core budget allows.  Jobs are started in
+//the order they were added: if the next one doesn't fit yet, the queue waits for running jobs to finish rather than
+//letting later ones jump ahead of it.  A job too big for the whole budget is run on its own.  Once start has been
+//called, update has to be called regularly (by a timer in the GUI) to start jobs and keep track of them.  The queue's
+//state can be saved to a file and loaded again, so a batch that was stopped carries on where it left off.
+class JobQueue
+{
+public:
+    JobQueue();
+    ~JobQueue();
+
+    void setBudget(qint64 memoryBudgetP, int coreBudgetP);
+    RenderJob * addJob(const QString & settingsFile, const QString & outputPath);
+    void removeJob(int index);
+    bool update();
+    void start();
+    void stop();
+    bool isRunning();
+    bool isFinished();
+    qint64 memoryInUse();
+    int coresInUse();
+    int jobCount(RenderJob::Status status);
+
+    bool saveState(const QString & fileName);
+    bool loadState(const QString & fileName);
+
+    QVector<RenderJob *> jobs;
+    qint64 memoryBudget;
+    int coreBudget;
+
+private:
+    bool running;
+};
+
+#endif // JOBQUEUE_H
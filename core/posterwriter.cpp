@@ -0,0 +1,433 @@
+#include "posterwriter.h"
+#include <QDataStream>
+#include <cstring>
+
+static const char pngSignature[8] = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n'};
+
+//IDAT chunks are written whenever this much compressed data has built up
+static const int pngChunkSize = 1 << 16;
+
+//The rows of a TIFF are grouped into strips of about this many bytes
+static const int tiffStripSize = 1 << 20;
+
+//The bands handed to writeRows should be about this big
+static const int bandSize = 1 << 24;
+
+PosterWriter::PosterWriter()
+{
+    format = pngPoster;
+    width = 0;
+    height = 0;
+    compressionLevel = Z_DEFAULT_COMPRESSION;
+    rowsWritten = 0;
+    failed = false;
+    deflaterOpen = false;
+    rowsPerStrip = 1;
+    compressedBytes = 0;
+    memset(&deflater, 0, sizeof(deflater));
+}
+
+
+
+
+
+PosterWriter::~PosterWriter()
+{
+    if (deflaterOpen)
+        deflateEnd(&deflater);
+}
+
+
+
+
+
+//TIFF files are named .tif or .tiff, and anything else is a PNG
+int PosterWriter::formatForFileName(const QString & fileName)
+{
+    if ( (fileName.endsWith(".tif", Qt::CaseInsensitive))||(fileName.endsWith(".tiff", Qt::CaseInsensitive)) )
+        return tiffPoster;
+    return pngPoster;
+}
+
+
+
+
+
+//This function starts a new image.  If paletteP is empty the image is 24-bit color, otherwise it is indexed.
+//compressionLevelP is a zlib level, from 1 (fastest) to 9 (smallest).
+bool PosterWriter::open(const QString & fileName, int formatP, int widthP, int heightP, const QVector<QRgb> & paletteP, int compressionLevelP)
+{
+    format = formatP;
+    width = widthP;
+    height = heightP;
+    palette = paletteP;
+    compressionLevel = compressionLevelP;
+    rowsWritten = 0;
+    failed = false;
+
+    if ( (width <= 0)||(height <= 0)||(palette.size() > 256) )
+        return false;
+
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    fileRow.resize(bytesPerFileRow());
+
+    if (format == tiffPoster)
+    {
+        //The header points to the directory, which isn't known until the end
+        QDataStream stream(&file);
+        stream.setByteOrder(QDataStream::LittleEndian);
+        stream.writeRawData("II", 2);
+        stream << quint16(42) << quint32(0);
+
+        int rowBytes = fileRow.size();
+        rowsPerStrip = qBound(1, tiffStripSize / rowBytes, height);
+        strip.clear();
+        strip.reserve(rowsPerStrip * rowBytes);
+        stripOffsets.clear();
+        stripByteCounts.clear();
+        failed = (stream.status() != QDataStream::Ok);
+    }
+    else
+    {
+        if (deflaterOpen)
+            deflateEnd(&deflater);
+        memset(&deflater, 0, sizeof(deflater));
+        if (deflateInit(&deflater, compressionLevel) != Z_OK)
+        {
+            file.close();
+            file.remove();
+            return false;
+        }
+        deflaterOpen = true;
+        compressedBuffer.resize(pngChunkSize);
+        compressedBytes = 0;
+        failed = !writePngHeader();
+    }
+
+    if (failed)
+    {
+        file.close();
+        file.remove();
+    }
+    return !failed;
+}
+
+
+
+
+
+//This function returns how many rows the caller should put in each band, so a band takes up about 16 MB
+int PosterWriter::rowsPerBand()
+{
+    int inputBytesPerPixel = palette.isEmpty() ? 4 : 1;
+    return qBound(1, bandSize / qMax(1, width * inputBytesPerPixel), qMax(1, height));
+}
+
+
+
+
+
+//This function writes the next rowCount rows of the image.  Each row is bytesPerLine bytes after the one before.
+bool PosterWriter::writeRows(const uchar * rows, int rowCount, int bytesPerLine)
+{
+    if ( (!file.isOpen())||(failed) )
+        return false;
+
+    rowCount = qMin(rowCount, height - rowsWritten);
+    for (int i = 0; (i < rowCount)&&(!failed); i++)
+    {
+        makeFileRow(rows + i * bytesPerLine);
+
+        if (format == tiffPoster)
+        {
+            strip.append(fileRow);
+            if (strip.size() >= rowsPerStrip * fileRow.size())
+                failed = !writeTiffStrip();
+        }
+        else
+            failed = !deflateData(reinterpret_cast<const uchar *>(fileRow.constData()), fileRow.size(), Z_NO_FLUSH);
+
+        rowsWritten++;
+    }
+
+    return !failed;
+}
+
+
+
+
+
+//This function finishes the file.  It fails if any of the rows are missing.
+bool PosterWriter::close()
+{
+    if (!file.isOpen())
+        return false;
+
+    if (rowsWritten < height)
+        failed = true;
+
+    if (!failed)
+    {
+        if (format == tiffPoster)
+            failed = ( (!writeTiffStrip())||(!writeTiffDirectory()) );
+        else
+            failed = ( (!deflateData(0, 0, Z_FINISH))||(!writePngChunk("IEND", QByteArray())) );
+    }
+
+    if (deflaterOpen)
+    {
+        deflateEnd(&deflater);
+        deflaterOpen = false;
+    }
+    file.close();
+    if (failed)
+        file.remove();
+
+    return !failed;
+}
+
+
+
+
+
+int PosterWriter::bytesPerFileRow()
+{
+    int pixelBytes = palette.isEmpty() ? 3 : 1;
+    if (format == tiffPoster)
+        return width * pixelBytes;
+    return width * pixelBytes + 1;
+}
+
+
+
+
+
+//This function turns one row as it was given into the bytes stored in the file.  PNG rows are stored unfiltered, as
+//the grid's long runs of one color already compress well.
+void PosterWriter::makeFileRow(const uchar * row)
+{
+    uchar * output = reinterpret_cast<uchar *>(fileRow.data());
+    if (format == pngPoster)
+        *output++ = 0;
+
+    if (!palette.isEmpty())
+    {
+        memcpy(output, row, width);
+        return;
+    }
+
+    const QRgb * pixels = reinterpret_cast<const QRgb *>(row);
+    for (int x = 0; x < width; x++)
+    {
+        *output++ = uchar(qRed(pixels[x]));
+        *output++ = uchar(qGreen(pixels[x]));
+        *output++ = uchar(qBlue(pixels[x]));
+    }
+}
+
+
+
+
+
+bool PosterWriter::writePngHeader()
+{
+    if (file.write(pngSignature, 8) != 8)
+        return false;
+
+    QByteArray header;
+    QDataStream headerStream(&header, QIODevice::WriteOnly);
+    headerStream << quint32(width) << quint32(height) << quint8(8) << quint8(palette.isEmpty() ? 2 : 3)
+                 << quint8(0) << quint8(0) << quint8(0);
+    if (!writePngChunk("IHDR", header))
+        return false;
+
+    if (palette.isEmpty())
+        return true;
+
+    QByteArray colors;
+    for (int i = 0; i < palette.size(); i++)
+    {
+        colors.append(char(qRed(palette[i])));
+        colors.append(char(qGreen(palette[i])));
+        colors.append(char(qBlue(palette[i])));
+    }
+    return writePngChunk("PLTE", colors);
+}
+
+
+
+
+
+//This function adds data to the PNG's zlib stream and writes out an IDAT chunk each time the buffer fills.  With
+//Z_FINISH, the stream is ended and whatever is left in the buffer is written.
+bool PosterWriter::deflateData(const uchar * data, int length, int flush)
+{
+    deflater.next_in = const_cast<Bytef *>(data);
+    deflater.avail_in = uInt(length);
+
+    while (true)
+    {
+        deflater.next_out = reinterpret_cast<Bytef *>(compressedBuffer.data()) + compressedBytes;
+        deflater.avail_out = uInt(compressedBuffer.size() - compressedBytes);
+
+        int result = deflate(&deflater, flush);
+        if (result == Z_STREAM_ERROR)
+            return false;
+        compressedBytes = compressedBuffer.size() - int(deflater.avail_out);
+
+        bool finished = ( (flush == Z_FINISH)&&(result == Z_STREAM_END) );
+        if ( (deflater.avail_out == 0)||( (finished)&&(compressedBytes > 0) ) )
+        {
+            if (!writePngChunk("IDAT", QByteArray::fromRawData(compressedBuffer.constData(), compressedBytes)))
+                return false;
+            compressedBytes = 0;
+        }
+
+        //Without Z_FINISH, zlib is done for now once it has taken all of the input and not filled the buffer
+        if (finished)
+            return true;
+        if ( (flush != Z_FINISH)&&(deflater.avail_in == 0)&&(deflater.avail_out > 0) )
+            return true;
+    }
+}
+
+
+
+
+
+bool PosterWriter::writePngChunk(const char * type, const QByteArray & data)
+{
+    uLong crc = crc32(0, reinterpret_cast<const Bytef *>(type), 4);
+    crc = crc32(crc, reinterpret_cast<const Bytef *>(data.constData()), uInt(data.size()));
+
+    QDataStream stream(&file);
+    stream << quint32(data.size());
+    stream.writeRawData(type, 4);
+    stream.writeRawData(data.constData(), data.size());
+    stream << quint32(crc);
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+
+
+
+
+//This function compresses the rows gathered so far into one strip.  The compressed strips are Adobe deflate, which is
+//just a zlib stream.
+bool PosterWriter::writeTiffStrip()
+{
+    if (strip.isEmpty())
+        return true;
+
+    uLongf compressedSize = compressBound(uLong(strip.size()));
+    QByteArray compressed(int(compressedSize), Qt::Uninitialized);
+    if (compress2(reinterpret_cast<Bytef *>(compressed.data()), &compressedSize,
+                  reinterpret_cast<const Bytef *>(strip.constData()), uLong(strip.size()), compressionLevel) != Z_OK)
+        return false;
+
+    //A plain TIFF can only point to the first 4 GB
+    qint64 offset = file.pos();
+    if (offset + qint64(compressedSize) > qint64(0xFFFFFFFFLL))
+        return false;
+
+    if (file.write(compressed.constData(), qint64(compressedSize)) != qint64(compressedSize))
+        return false;
+
+    stripOffsets.append(quint32(offset));
+    stripByteCounts.append(quint32(compressedSize));
+    strip.clear();
+    return true;
+}
+
+
+
+
+
+//This function writes the image file directory, which describes the image and lists the strips, and points the header
+//at it.  Values that don't fit in an entry go just before the directory.
+bool PosterWriter::writeTiffDirectory()
+{
+    enum {tiffShort = 3, tiffLong = 4};
+    bool indexed = !palette.isEmpty();
+    int stripCount = stripOffsets.size();
+
+    //TIFF offsets have to be even
+    if (file.pos() % 2 == 1)
+        file.write("", 1);
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 bitsOffset = quint32(file.pos());
+    if (!indexed)
+        stream << quint16(8) << quint16(8) << quint16(8);
+
+    quint32 stripOffsetsOffset = quint32(file.pos());
+    if (stripCount > 1)
+    {
+        for (int i = 0; i < stripCount; i++)
+            stream << stripOffsets[i];
+    }
+    quint32 stripByteCountsOffset = quint32(file.pos());
+    if (stripCount > 1)
+    {
+        for (int i = 0; i < stripCount; i++)
+            stream << stripByteCounts[i];
+    }
+
+    //The color map has 256 entries of each of red, green and blue, scaled up to 16 bits
+    quint32 colorMapOffset = quint32(file.pos());
+    if (indexed)
+    {
+        for (int channel = 0; channel < 3; channel++)
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                QRgb color = (i < palette.size()) ? palette[i] : qRgb(0, 0, 0);
+                int value = (channel == 0) ? qRed(color) : ( (channel == 1) ? qGreen(color) : qBlue(color) );
+                stream << quint16(value * 257);
+            }
+        }
+    }
+
+    quint32 directoryOffset = quint32(file.pos());
+    if (file.pos() > qint64(0xFFFFFFFFLL) - 256)
+        return false;
+
+    //Each entry is a tag, a type, a count and either the value or where to find it.  Short values are padded.
+    struct Entry {quint16 tag; quint16 type; quint32 count; quint32 value;};
+    QVector<Entry> entries;
+    entries.append({256, tiffLong, 1, quint32(width)});
+    entries.append({257, tiffLong, 1, quint32(height)});
+    if (indexed)
+        entries.append({258, tiffShort, 1, 8});
+    else
+        entries.append({258, tiffShort, 3, bitsOffset});
+    entries.append({259, tiffShort, 1, 8});
+    entries.append({262, tiffShort, 1, quint32(indexed ? 3 : 2)});
+    entries.append({273, tiffLong, quint32(stripCount), (stripCount > 1) ? stripOffsetsOffset : stripOffsets[0]});
+    entries.append({277, tiffShort, 1, quint32(indexed ? 1 : 3)});
+    entries.append({278, tiffLong, 1, quint32(rowsPerStrip)});
+    entries.append({279, tiffLong, quint32(stripCount), (stripCount > 1) ? stripByteCountsOffset : stripByteCounts[0]});
+    entries.append({284, tiffShort, 1, 1});
+    if (indexed)
+        entries.append({320, tiffShort, 768, colorMapOffset});
+
+    stream << quint16(entries.size());
+    for (int i = 0; i < entries.size(); i++)
+        stream << entries[i].tag << entries[i].type << entries[i].count << entries[i].value;
+    stream << quint32(0);
+
+    //Point the header at the directory
+    if (stream.status() != QDataStream::Ok)
+        return false;
+    if (!file.seek(4))
+        return false;
+    stream << directoryOffset;
+
+    return (stream.status() == QDataStream::Ok);
+}
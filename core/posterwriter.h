@@ -0,0 +1,64 @@
+#ifndef POSTERWRITER_H
+#define POSTERWRITER_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QImage>
+#include <zlib.h>
+
+//This class writes a single image too big to hold in memory, such as a poster of the whole grid, as a PNG or TIFF
+//file.  The image is handed over a band of rows at a time and each band is compressed and written straight away, so
+//the memory used depends on the width of the image and not on its height.  The image is either 8-bit indexed (given
+//a palette of up to 256 colors), where each pixel is one byte, or 24-bit color, where each pixel is a QRgb.
+class PosterWriter
+{
+public:
+    enum PosterFormat {pngPoster = 0, tiffPoster = 1};
+
+    PosterWriter();
+    ~PosterWriter();
+
+    static int formatForFileName(const QString & fileName);
+
+    bool open(const QString & fileName, int formatP, int widthP, int heightP, const QVector<QRgb> & paletteP, int compressionLevelP);
+    bool writeRows(const uchar * rows, int rowCount, int bytesPerLine);
+    bool close();
+    int rowsPerBand();
+
+private:
+    QFile file;
+    int format;
+    int width;
+    int height;
+    QVector<QRgb> palette;
+    int compressionLevel;
+    int rowsWritten;
+    bool failed;
+
+    //One row as it is stored in the file, which for a PNG starts with the filter type
+    QByteArray fileRow;
+
+    //For PNGs, the whole image is one zlib stream, which is cut up into IDAT chunks as it fills the buffer
+    z_stream deflater;
+    bool deflaterOpen;
+    QByteArray compressedBuffer;
+    int compressedBytes;
+
+    //For TIFFs, each strip of rows is compressed on its own, and where they went is written at the end
+    QByteArray strip;
+    int rowsPerStrip;
+    QVector<quint32> stripOffsets;
+    QVector<quint32> stripByteCounts;
+
+    int bytesPerFileRow();
+    void makeFileRow(const uchar * row);
+    bool writePngHeader();
+    bool deflateData(const uchar * data, int length, int flush);
+    bool writePngChunk(const char * type, const QByteArray & data);
+    bool writeTiffStrip();
+    bool writeTiffDirectory();
+};
+
+#endif // POSTERWRITER_H
@@ -0,0 +1,379 @@
+#include "renderjob.h"
+#include <QDir>
+
+//The pipeline saves a checkpoint for every this many frames
+static const int checkpointInterval = 50;
+
+//This thread gets a job's simulation to the frame the job carries on from, from the nearest checkpoint.  abort stops
+//the replay within a frame, for when the job is stopped while it is still catching up.
+class JobRestoreThread : public QThread
+{
+public:
+    JobRestoreThread(AntSimulation * simulationP, const QString & directoryP, int frameNumberP, Camera * cameraP)
+    {
+        simulation = simulationP;
+        directory = directoryP;
+        frameNumber = frameNumberP;
+        camera = cameraP;
+        abortRequested = 0;
+    }
+
+    void abort()
+    {
+        abortRequested = 1;
+    }
+
+protected:
+    void run()
+    {
+        simulation->create();
+        simulation->resetToStart();
+        simulation->resetCamera(camera);
+        Camera * followingCamera = simulation->settings.followPattern ? camera : 0;
+        if (frameNumber > 1)
+            simulation->restoreFromCheckpoints(directory, frameNumber, followingCamera, &abortRequested);
+    }
+
+private:
+    AntSimulation * simulation;
+    QString directory;
+    int frameNumber;
+    Camera * camera;
+    QAtomicInt abortRequested;
+};
+
+RenderJob::RenderJob(const QString & settingsFileP, const QString & outputPathP)
+{
+    settingsFile = settingsFileP;
+    outputPath = outputPathP;
+    status = waitingJob;
+
+    memoryNeeded = 0;
+    coresNeeded = 1;
+    framesDone = 0;
+    frameTotal = 0;
+    failedFrames = 0;
+
+    simulation = 0;
+    renderPipeline = 0;
+    writerThreads = 1;
+    streamOutput = false;
+    anyStreamOutput = false;
+    framesDoneAtStart = 0;
+    restoreThread = 0;
+    firstFrame = 0;
+}
+
+
+
+
+
+RenderJob::~RenderJob()
+{
+    //The pipeline, or the restore, has to stop before the simulation it is working on goes
+    finishRun();
+}
+
+
+
+
+
+//This function reads the job's settings and works out what it needs.  It returns false, and marks the job as failed, if
+//the settings can't be read.
+bool RenderJob::prepare()
+{
+    AntSimulation settingsReader;
+    if (!settingsReader.loadSettings(settingsFile))
+    {
+        status = failedJob;
+        message = "Couldn't read the settings file";
+        return false;
+    }
+    AntSettings * settings = &(settingsReader.settings);
+
+    //Each output gets a couple of threads to save its frames, except for a stream, which is written by just one.  The
+    //simulation has a core of its own.  The blending is shared out over the worker pool, so it isn't counted here.
+    streamOutput = FrameWriter::isStreamFormat(settings->outputFormat);
+    anyStreamOutput = RenderPipeline::hasStreamOutput(settings);
+    outputExtension = FrameWriter::fileExtension(settings->outputFormat);
+    writerThreads = streamOutput ? 1 : 2;
+    coresNeeded = 1 + writerThreads * (1 + settings->extraOutputs.size());
+    memoryNeeded = estimateMemory(settings, writerThreads);
+
+    frameTotal = settings->frameCount;
+    if (settings->saveZeroFrame)
+        frameTotal++;
+    return true;
+}
+
+
+
+
+
+//This function estimates the memory, in bytes, that a render with these settings uses
+qint64 RenderJob::estimateMemory(const AntSettings * settings, int writerThreads)
+{
+    qint64 cellSize = qMax(1, settings->cellSize);
+    qint64 frameBytes = qint64(settings->pixelWidth) * settings->pixelHeight * 4;
+    qint64 columns = (settings->pixelWidth + cellSize - 1) / cellSize + 2 * settings->gridBuffer;
+    qint64 rows = (settings->pixelHeight + cellSize - 1) / cellSize + 2 * settings->gridBuffer;
+    qint64 cells = columns * rows;
+
+    //The ant grid's states and the grid image
+    qint64 memory = cells * qint64(sizeof(int)) + frameBytes;
+
+    //The blender.  The samples themselves aren't kept: the image blender has a 32-bit total for every byte of the
+    //image, and the change blender a copy of the image plus an index for every pixel.
+    if ( (settings->blendChangedCellsOnly)&&(!settings->followPattern) )
+        memory += 2 * frameBytes;
+    else
+        memory += 4 * frameBytes;
+
+    //The change log has an index for every cell and an entry for each change in a frame, of which there can be one a step
+    if ( (settings->blendChangedCellsOnly)||(!settings->extraOutputs.isEmpty()) )
+    {
+        qint64 changesPerFrame = qMin(qint64(settings->samplesPerFrame) * settings->stepsPerSample, cells * settings->samplesPerFrame);
+        memory += cells * qint64(sizeof(int)) + changesPerFrame * qint64(sizeof(CellChange));
+    }
+
+    //Every frame that can be queued for saving, being saved, blended or shown comes from the frame pool
+    memory += (3 * writerThreads + 3) * frameBytes;
+
+    //Following the pattern needs the zoomed-out summary of the grid, which all together has about a third of a
+    //histogram for every cell, and an image for the camera's view
+    if (settings->followPattern)
+        memory += cells * settings->stateCount * qint64(sizeof(quint32)) / 3 + frameBytes;
+
+    //Each extra output has its own image, change blender and frame pool
+    for (int i = 0; i < settings->extraOutputs.size(); i++)
+    {
+        qint64 outputBytes = qint64(settings->extraOutputs[i].pixelWidth) * settings->extraOutputs[i].pixelHeight * 4;
+        memory += (3 + 3 * writerThreads + 3) * outputBytes;
+    }
+
+    return memory;
+}
+
+
+
+
+
+//This function starts the job running, or carries it on after the frames it has already saved.  A stream can't be
+//added to, so a job with any output in a stream format always starts again from the beginning.  It returns false if
+//the job couldn't be started.  The simulation is brought up to the first frame on another thread, and update starts
+//the pipeline once it is.
+bool RenderJob::start()
+{
+    if ( (status == runningJob)||(status == finishedJob) )
+        return false;
+
+    //The settings file is read again in case it has changed since the job was added
+    if (!prepare())
+        return false;
+
+    delete renderPipeline;
+    renderPipeline = 0;
+    delete simulation;
+    simulation = new AntSimulation();
+    simulation->loadSettings(settingsFile);
+    AntSettings * settings = &(simulation->settings);
+
+    if ( (!streamOutput)&&(!QDir().mkpath(outputPath)) )
+    {
+        status = failedJob;
+        message = "Couldn't make the output directory";
+        finishRun();
+        return false;
+    }
+
+    //A stream can't be added to, and nor can frames saved with rules or a start that have since changed, which shows
+    //in the checkpoints.  Either way the job starts again.
+    if ( (anyStreamOutput)||(!simulation->checkpointsMatch(checkpointDirectory())) )
+        framesDone = 0;
+    framesDoneAtStart = framesDone;
+    failedFrames = 0;
+    message = "";
+
+    //The frames are numbered from 1, or from 0 if the zero frame is saved
+    firstFrame = framesDone;
+    if (!settings->saveZeroFrame)
+        firstFrame++;
+
+    //Checkpoints left from an earlier run that started from scratch, or from settings that have changed, go.  A job with
+    //a stream always starts from scratch, so it doesn't use them.
+    if ( (framesDone == 0)||(anyStreamOutput) )
+        QDir(checkpointDirectory()).removeRecursively();
+    if (!anyStreamOutput)
+        QDir().mkpath(checkpointDirectory());
+
+    //Move the simulation, and the camera if it follows the pattern, on to where the job got to
+    if (firstFrame > 1)
+        message = "Catching up to frame " + QString::number(firstFrame);
+    restoreThread = new JobRestoreThread(simulation, checkpointDirectory(), firstFrame, &startingCamera);
+    restoreThread->start();
+
+    status = runningJob;
+    return true;
+}
+
+
+
+
+
+//This function starts rendering, once the simulation has been brought up to the first frame
+void RenderJob::startPipeline()
+{
+    AntSettings * settings = &(simulation->settings);
+    message = "";
+
+    renderPipeline = new RenderPipeline(simulation->displayGrid, simulation->antGrid, simulation->antCounter, settings, &gridMutex);
+    renderPipeline->setWriterThreadCount(writerThreads * (1 + settings->extraOutputs.size()));
+    if (firstFrame > 1)
+        renderPipeline->setStartingCamera(startingCamera);
+    if (!anyStreamOutput)
+        renderPipeline->setCheckpoints(simulation, checkpointDirectory(), checkpointInterval);
+    renderPipeline->startRender(renderPath(), firstFrame);
+}
+
+
+
+
+
+//This function stops the job.  It goes back to waiting, and will carry on from where it got to if it is started again.
+//If the simulation is still catching up, that is abandoned.
+void RenderJob::stop()
+{
+    if (status != runningJob)
+        return;
+
+    if (renderPipeline != 0)
+    {
+        renderPipeline->stopRender();
+        framesDone = framesDoneAtStart + renderPipeline->framesWritten();
+    }
+    message = "";
+    status = waitingJob;
+    finishRun();
+}
+
+
+
+
+
+//This function brings the job's progress up to date.  It returns true if the job has finished (or failed) since the
+//last call.
+bool RenderJob::update()
+{
+    if (status != runningJob)
+        return false;
+
+    //Start the pipeline once the simulation has caught up
+    if (restoreThread != 0)
+    {
+        if (!restoreThread->isFinished())
+            return false;
+        delete restoreThread;
+        restoreThread = 0;
+        startPipeline();
+    }
+
+    framesDone = framesDoneAtStart + renderPipeline->framesWritten();
+    if (renderPipeline->isRunning())
+        return false;
+
+    //Frames that couldn't be saved are missing from the output, so if the job is run again it starts over
+    failedFrames = renderPipeline->failedFrameCount();
+    if ( (renderPipeline->renderCompleted())&&(failedFrames == 0) )
+    {
+        status = finishedJob;
+        QDir(checkpointDirectory()).removeRecursively();
+    }
+    else
+    {
+        status = failedJob;
+        if (failedFrames > 0)
+            message = QString::number(failedFrames) + " frames could not be saved";
+        else
+            message = "The render stopped before the last frame";
+        framesDone = 0;
+    }
+
+    finishRun();
+    return true;
+}
+
+
+
+
+
+//This function frees the memory of the last run.  A restore that is still going is told to stop, and only has to get
+//to the end of the frame it is on.
+void RenderJob::finishRun()
+{
+    if (restoreThread != 0)
+    {
+        restoreThread->abort();
+        restoreThread->wait();
+    }
+    delete restoreThread;
+    restoreThread = 0;
+
+    delete renderPipeline;
+    delete simulation;
+    renderPipeline = 0;
+    simulation = 0;
+}
+
+
+
+
+
+//This function returns where the job keeps its checkpoints, which is inside its output directory.  They are removed
+//once the job has finished.
+QString RenderJob::checkpointDirectory()
+{
+    return outputPath + QDir::separator() + "checkpoints";
+}
+
+//This function returns where the frames go: the output directory, or for a stream, a file with the stream's extension
+QString RenderJob::renderPath()
+{
+    if (!streamOutput)
+        return outputPath;
+    return outputPath + "." + outputExtension;
+}
+
+
+
+
+
+QString RenderJob::statusName(Status status)
+{
+    switch (status)
+    {
+    case waitingJob:
+        return "waiting";
+    case runningJob:
+        return "running";
+    case finishedJob:
+        return "finished";
+    case failedJob:
+        return "failed";
+    }
+    return "";
+}
+
+
+
+
+
+RenderJob::Status RenderJob::statusFromName(const QString & name)
+{
+    if (name == "running")
+        return runningJob;
+    if (name == "finished")
+        return finishedJob;
+    if (name == "failed")
+        return failedJob;
+    return waitingJob;
+}
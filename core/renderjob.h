@@ -0,0 +1,71 @@
+#ifndef RENDERJOB_H
+#define RENDERJOB_H
+
+#include <QString>
+#include <QMutex>
+#include <QThread>
+
+#include "antsimulation.h"
+#include "renderpipeline.h"
+
+class JobRestoreThread;
+
+//This class is one render in a JobQueue: a settings file, where its frames go, what it is expected to need and how far
+//it has got.  While it runs it has its own simulation and render pipeline, so several jobs can run at once.  A job
+//that is stopped part way carries on after the frames it has already saved when it is started again.  The pipeline
+//saves checkpoints in the job's output directory as it goes, and a job that carries on starts from the latest one, on
+//a thread of its own, so the queue isn't held up while the simulation catches up.
+class RenderJob
+{
+public:
+    enum Status {waitingJob = 0, runningJob = 1, finishedJob = 2, failedJob = 3};
+
+    RenderJob(const QString & settingsFileP, const QString & outputPathP);
+    ~RenderJob();
+
+    bool prepare();
+    bool start();
+    void stop();
+    bool update();
+    QString renderPath();
+    QString checkpointDirectory();
+
+    static QString statusName(Status status);
+    static Status statusFromName(const QString & name);
+
+    QString settingsFile;
+    QString outputPath;
+    Status status;
+    QString message;
+
+    //What the job is expected to need while it runs, worked out from its settings by prepare
+    qint64 memoryNeeded;
+    int coresNeeded;
+
+    //framesDone is the number of frames saved in order from the start of the render, which is where the job carries on
+    //from.  frameTotal includes the zero frame if it is saved.
+    int framesDone;
+    int frameTotal;
+    int failedFrames;
+
+private:
+    AntSimulation * simulation;
+    QMutex gridMutex;
+    RenderPipeline * renderPipeline;
+    int writerThreads;
+    bool streamOutput;
+    bool anyStreamOutput;
+    QString outputExtension;
+    int framesDoneAtStart;
+
+    //While the simulation is being brought up to the first frame, the thread doing it, and where the camera will be
+    JobRestoreThread * restoreThread;
+    Camera startingCamera;
+    int firstFrame;
+
+    void startPipeline();
+    void finishRun();
+    static qint64 estimateMemory(const AntSettings * settings, int writerThreads);
+};
+
+#endif // RENDERJOB_H
@@ -0,0 +1,245 @@
+#include "renderoutput.h"
+#include <QDir>
+#include <QFileInfo>
+#include <cstring>
+
+RenderOutput::RenderOutput(const RenderOutputSettings & outputSettingsP, AntGrid * antGridP, AntSettings * settingsP)
+{
+    outputSettings = outputSettingsP;
+    antGrid = antGridP;
+    settings = settingsP;
+
+    //The states the output doesn't give a color for keep their own
+    palette = antGrid->statePalette();
+    for (int i = 0; (i < palette.size())&&(i < outputSettings.palette.size()); i++)
+        palette[i] = outputSettings.palette[i];
+
+    outputGrid = new Grid(outputSettings.pixelWidth, outputSettings.pixelHeight, outputSettings.cellSize, QColor(palette[0]));
+    outputCounter = new AntCounter(outputGrid, settings, antGrid->getStateArray());
+    changeBlender.setFramePool(&framePool);
+    frameWriter.setFramePool(&framePool);
+
+    changesDrawn = 0;
+    drawCountAtFrameStart = 0;
+    previousFrameMatchesGrid = false;
+}
+
+
+
+
+
+RenderOutput::~RenderOutput()
+{
+    //The writer threads have to be stopped before the grid goes
+    frameWriter.cancel();
+
+    delete outputCounter;
+    delete outputGrid;
+}
+
+
+
+
+
+//This function returns the cells (in display terms) that the output shows, including any that are only partly visible
+QRect RenderOutput::cellArea()
+{
+    return QRect(outputSettings.firstColumn, outputSettings.firstRow, outputGrid->columnCount, outputGrid->rowCount);
+}
+
+//Frames are saved into a folder named after the output, or a stream file of that name, next to the main output
+QString RenderOutput::outputPath()
+{
+    return filePath;
+}
+
+
+
+
+
+//This function draws the output's starting image and starts its writer.  The grid should already be as it is at the
+//start of firstFrame, the number of the first frame the output will be given.  baseDirectory is where the output's
+//folder or stream file goes.  The counter box starts the size of mainCounter's, which has seen every count so far,
+//even when the render starts part way through.
+void RenderOutput::start(const QString & baseDirectory, int writerThreads, int queueDepth, int firstFrame,
+                         const AntCounter & mainCounter)
+{
+    int outputFormat = outputSettings.outputFormat;
+    if (!FrameWriter::formatSupported(outputFormat))
+        outputFormat = FrameWriter::pngFormat;
+    fileExtension = FrameWriter::fileExtension(outputFormat);
+
+    //Draw the whole output once.  After this, only the cells in the change log are drawn.
+    antGrid->drawStateArea(outputGrid, outputSettings.firstColumn, outputSettings.firstRow, palette);
+    if ( (settings->showAntColor)&&(!antGrid->outOfRange) )
+        outputGrid->drawSquare(antGrid->antX - settings->gridBuffer - outputSettings.firstColumn,
+                               antGrid->antY - settings->gridBuffer - outputSettings.firstRow, settings->antColor);
+    outputCounter->copyBoxSize(mainCounter);
+    if ( (outputSettings.showOverlay)&&( (settings->showCounter)||(settings->showRules) ) )
+        outputCounter->paintCountAndRules();
+
+    changeBlender.initialize(outputSettings.cellSize, *(outputGrid->gridImage), QPoint(outputSettings.firstColumn, outputSettings.firstRow));
+    framePool.setFrameFormat(outputGrid->gridImage->size(), QImage::Format_RGB32, 3 * writerThreads + 3);
+    changesDrawn = 0;
+    drawCountAtFrameStart = outputGrid->drawCount;
+    previousFrame = QImage();
+    previousFrameMatchesGrid = false;
+
+    if (FrameWriter::isStreamFormat(outputFormat))
+    {
+        filePath = baseDirectory + QDir::separator() + outputSettings.name + "." + fileExtension;
+        videoStream.setOutput(filePath, FrameWriter::streamFormat(outputFormat), 30);
+        frameWriter.startStream(&videoStream, queueDepth, firstFrame);
+    }
+    else
+    {
+        filePath = baseDirectory + QDir::separator() + outputSettings.name;
+        QDir().mkpath(filePath);
+        frameWriter.start(writerThreads, queueDepth, firstFrame);
+    }
+    frameWriter.setPngCompression(settings->pngCompression);
+    frameWriter.setPaletteReduction(settings->paletteFrames);
+}
+
+
+
+
+
+void RenderOutput::writeZeroFrame()
+{
+    previousFrame = copyGridImage();
+    previousFrameMatchesGrid = true;
+    frameWriter.write(previousFrame, frameFileName(0), 0);
+}
+
+
+
+
+
+//This function brings the output's image up to date with a sample that has just been made, and adds it to the blend.
+//The grid mutex must be held.
+void RenderOutput::addSample(int sample)
+{
+    //The change log is cleared at the start of each frame
+    if (sample == 0)
+        changesDrawn = 0;
+
+    //Every cell the ant has changed since the last sample, including the one it has just left, is in the log
+    const QVector<CellChange> & changes = antGrid->changeLog;
+    for (int i = changesDrawn; i < changes.size(); i++)
+        outputGrid->drawSquare(changes[i].column - outputSettings.firstColumn, changes[i].row - outputSettings.firstRow,
+                               QColor(palette[ changes[i].state ]));
+    changesDrawn = changes.size();
+
+    QPoint antCell(antGrid->antX - settings->gridBuffer, antGrid->antY - settings->gridBuffer);
+    if ( (settings->showAntColor)&&(!antGrid->outOfRange) )
+        outputGrid->drawSquare(antCell.x() - outputSettings.firstColumn, antCell.y() - outputSettings.firstRow, settings->antColor);
+
+    QRect overlayArea;
+    if ( (outputSettings.showOverlay)&&( (settings->showCounter)||(settings->showRules) ) )
+    {
+        outputCounter->paintCountAndRules();
+        overlayArea = outputCounter->paintedArea;
+    }
+
+    changeBlender.addSample(*(outputGrid->gridImage), changes, antCell, overlayArea);
+}
+
+
+
+
+
+//This function blends the samples added since the last frame and queues the result.  As with the main output, a frame
+//where nothing was drawn is the grid image, and is a repeat if the last frame was too.
+bool RenderOutput::finishFrame(int frameNumber)
+{
+    QImage frame = changeBlender.blendImages();
+
+    bool gridChanged = ( ( (outputSettings.showOverlay)&&(settings->showCounter) )||(outputGrid->drawCount != drawCountAtFrameStart) );
+    drawCountAtFrameStart = outputGrid->drawCount;
+    if (!gridChanged)
+    {
+        //Hand the blended frame back, so its image can be leased again
+        framePool.release(frame);
+        return finishUnchangedFrame(frameNumber);
+    }
+
+    previousFrame = frame;
+    previousFrameMatchesGrid = false;
+    return writeFrame(frame, frameNumber);
+}
+
+
+
+
+
+//This function is for frames where nothing has been drawn on the output's grid, when no samples were made for it.
+bool RenderOutput::finishUnchangedFrame(int frameNumber)
+{
+    if (previousFrameMatchesGrid)
+        return frameWriter.writeRepeat(frameFileName(frameNumber), frameNumber);
+
+    previousFrame = copyGridImage();
+    previousFrameMatchesGrid = true;
+    return writeFrame(previousFrame, frameNumber);
+}
+
+
+
+
+
+bool RenderOutput::writeFrame(const QImage & frame, int frameNumber)
+{
+    return frameWriter.write(frame, frameFileName(frameNumber), frameNumber);
+}
+
+
+
+
+
+//This function waits for the last frames to be saved
+void RenderOutput::finish()
+{
+    frameWriter.finish();
+    previousFrame = QImage();
+    framePool.clear();
+}
+
+void RenderOutput::cancel()
+{
+    frameWriter.cancel();
+}
+
+int RenderOutput::framesWritten()
+{
+    return frameWriter.framesWrittenInOrder();
+}
+
+int RenderOutput::failedFrameCount()
+{
+    return frameWriter.failedFrameCount();
+}
+
+
+
+
+
+QImage RenderOutput::copyGridImage()
+{
+    QImage * gridImage = outputGrid->gridImage;
+    QImage copy = framePool.lease();
+    if ( (copy.size() != gridImage->size())||(copy.format() != gridImage->format())||(copy.bytesPerLine() != gridImage->bytesPerLine()) )
+        return gridImage->copy();
+
+    memcpy(copy.bits(), gridImage->constBits(), gridImage->sizeInBytes());
+    return copy;
+}
+
+
+
+
+
+QString RenderOutput::frameFileName(int frameNumber)
+{
+    return filePath + QDir::separator() + QString::number(frameNumber).rightJustified(5, '0') + "." + fileExtension;
+}
@@ -0,0 +1,69 @@
+#ifndef RENDEROUTPUT_H
+#define RENDEROUTPUT_H
+
+#include <QImage>
+#include <QVector>
+#include <QString>
+
+#include "grid.h"
+#include "antgrid.h"
+#include "antsettings.h"
+#include "antcounter.h"
+#include "changeblender.h"
+#include "framewriter.h"
+#include "videostream.h"
+#include "framepool.h"
+
+//This class is one of the extra outputs of a render.  It has its own grid image, at its own size and cell size and
+//showing its own part of the grid in its own colors, which it keeps up to date from the ant grid's change log as the
+//render goes.  So any number of outputs can be made from one run of the simulation, each blended and saved on its
+//own.  Apart from start, the functions are only called from the render thread, with the grid mutex held where noted.
+class RenderOutput
+{
+public:
+    RenderOutput(const RenderOutputSettings & outputSettingsP, AntGrid * antGridP, AntSettings * settingsP);
+    ~RenderOutput();
+
+    QRect cellArea();
+    QString outputPath();
+    void start(const QString & baseDirectory, int writerThreads, int queueDepth, int firstFrame, const AntCounter & mainCounter);
+    void writeZeroFrame();
+    void addSample(int sample);
+    bool finishFrame(int frameNumber);
+    bool finishUnchangedFrame(int frameNumber);
+    void finish();
+    void cancel();
+    int framesWritten();
+    int failedFrameCount();
+
+private:
+    RenderOutputSettings outputSettings;
+    AntGrid * antGrid;
+    AntSettings * settings;
+
+    Grid * outputGrid;
+    AntCounter * outputCounter;
+    ChangeBlender changeBlender;
+    FramePool framePool;
+    FrameWriter frameWriter;
+    VideoStream videoStream;
+
+    QVector<QRgb> palette;
+    QString filePath;
+    QString fileExtension;
+
+    //How much of this sample's change log has been drawn
+    int changesDrawn;
+
+    //As for the main output, the last frame made and whether it is the same as the grid image, so frames where
+    //nothing is drawn can be repeated
+    quint32 drawCountAtFrameStart;
+    QImage previousFrame;
+    bool previousFrameMatchesGrid;
+
+    bool writeFrame(const QImage & frame, int frameNumber);
+    QImage copyGridImage();
+    QString frameFileName(int frameNumber);
+};
+
+#endif // RENDEROUTPUT_H
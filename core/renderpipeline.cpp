@@ -0,0 +1,610 @@
+#include "renderpipeline.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QFile>
+#include <QMutexLocker>
+#include <cstring>
+
+RenderPipeline::RenderPipeline(Grid * displayGridP, AntGrid * antGridP, AntCounter * antCounterP, AntSettings * settingsP, QMutex * gridMutexP)
+{
+    //Store the pointers to the objects that the render will be working on
+    displayGrid = displayGridP;
+    antGrid = antGridP;
+    antCounter = antCounterP;
+    settings = settingsP;
+    gridMutex = gridMutexP;
+
+    imageBlender = new ImageBlender();
+    changeBlender = new ChangeBlender();
+    imageBlender->setFramePool(&framePool);
+    changeBlender->setFramePool(&framePool);
+    frameWriter.setFramePool(&framePool);
+
+    completed = false;
+    latestFrameNumber = 0;
+    latestFrameTime = 0;
+
+    blendChangedCells = false;
+    followPattern = false;
+    cameraGrid = 0;
+    cameraCounter = 0;
+    pyramidWasEnabled = false;
+    writerThreadCount = 0;
+    firstFrame = 0;
+    lastFrame = 0;
+    startingCameraSet = false;
+    checkpointSimulation = 0;
+    checkpointInterval = 0;
+}
+
+
+
+
+
+RenderPipeline::~RenderPipeline()
+{
+    //The thread must not be running when it is destroyed
+    stopRender();
+
+    qDeleteAll(extraOutputs);
+    delete cameraCounter;
+    delete cameraGrid;
+    delete imageBlender;
+    delete changeBlender;
+}
+
+
+
+
+
+//This function starts rendering frames into the passed directory, or into the passed file (or "-" for standard
+//output) for the video stream formats.  The grid should already have been reset to the
+//start of the animation.  To carry on with a render that was stopped, or to render just a range of frames, pass the
+//number of the first frame that is needed as firstFrameP, with the grid moved on to the end of the frame before it.
+//lastFrameP is the last frame to render, or -1 for the end.  The frames are the same as they would have been, as long
+//as the camera is set with setStartingCamera when it follows the pattern.  Starting a stream would empty its file, so
+//a render with any output in a stream format can't start part way through.  It returns false if the render wasn't
+//started.
+bool RenderPipeline::startRender(const QString & filePathP, int firstFrameP, int lastFrameP)
+{
+    //Quit if a render is already going
+    if (isRunning())
+        return false;
+    if ( (firstFrameP > 1)&&(hasStreamOutput(settings)) )
+        return false;
+
+    filePath = filePathP;
+    fileExtension = FrameWriter::fileExtension(settings->outputFormat);
+    if (!FrameWriter::formatSupported(settings->outputFormat))
+        fileExtension = FrameWriter::fileExtension(FrameWriter::pngFormat);
+    stopRequested = 0;
+    framePending = 0;
+    completed = false;
+
+    //The zero frame is only made at the very start, and the numbering starts at 1 without it
+    firstFrame = firstFrameP;
+    if ( (firstFrame == 0)&&(!settings->saveZeroFrame) )
+        firstFrame = 1;
+    lastFrame = settings->frameCount;
+    if ( (lastFrameP >= 0)&&(lastFrameP < lastFrame) )
+        lastFrame = lastFrameP;
+
+    qDeleteAll(extraOutputs);
+    extraOutputs.clear();
+    for (int i = 0; i < settings->extraOutputs.size(); i++)
+        extraOutputs.append(new RenderOutput(settings->extraOutputs[i], antGrid, settings));
+
+    //When the camera follows the pattern, the frames are drawn from the zoomed-out summary of the grid, so it has to be
+    //kept up to date.  The camera starts on the normal view, unless the render starts part way through.
+    followPattern = settings->followPattern;
+    delete cameraCounter;
+    delete cameraGrid;
+    cameraCounter = 0;
+    cameraGrid = 0;
+    pyramidWasEnabled = antGrid->pyramidEnabled();
+    if (followPattern)
+    {
+        QSize frameSize = displayGrid->gridImage->size();
+        cameraGrid = new Grid(frameSize.width(), frameSize.height(), 1, QColor(antGrid->statePalette()[0]));
+        cameraCounter = new AntCounter(cameraGrid, settings, antGrid->getStateArray());
+        antGrid->setPyramidEnabled(true);
+        camera.resetToGrid(frameSize, settings->cellSize);
+        if (startingCameraSet)
+        {
+            camera = startingCamera;
+            cameraCounter->copyBoxSize(*antCounter);
+        }
+    }
+    startingCameraSet = false;
+
+    //Get the blender ready.  In the changed cells mode, the ant grid logs its changes so the change blender knows
+    //where to look.  The extra outputs are drawn from the log too, so it has to cover their cells as well.  The
+    //change blender can't follow a moving camera, so with the camera every sample is blended in full.
+    blendChangedCells = ( (settings->blendChangedCellsOnly)&&(!followPattern) );
+    if ( (blendChangedCells)||(!extraOutputs.isEmpty()) )
+    {
+        QRect logArea(0, 0, displayGrid->columnCount, displayGrid->rowCount);
+        for (int i = 0; i < extraOutputs.size(); i++)
+            logArea |= extraOutputs[i]->cellArea();
+        antGrid->setChangeLogEnabled(true, logArea);
+    }
+    if (blendChangedCells)
+        changeBlender->initialize(settings->cellSize, *(displayGrid->gridImage));
+    else
+        imageBlender->initialize(settings->samplesPerFrame, true);
+
+    //Start the writer threads.  One core is left for the simulation, and the rest are shared between the outputs.
+    //The queue holds a couple of frames per thread, which is enough to smooth out the differences in speed without
+    //using much memory.  A stream has to be written in order, so it gets just one thread.  The animation plays at 30
+    //frames per second.
+    int writerThreads = qMax(1, (QThread::idealThreadCount() - 1) / (extraOutputs.size() + 1));
+    if (writerThreadCount > 0)
+        writerThreads = qMax(1, writerThreadCount / (extraOutputs.size() + 1));
+
+    //Every frame that can be in the queue, being saved, being blended or being shown gets an image up front
+    framePool.setFrameFormat(displayGrid->gridImage->size(), QImage::Format_RGB32, 3 * writerThreads + 3);
+
+    if (FrameWriter::isStreamFormat(settings->outputFormat))
+    {
+        videoStream.setOutput(filePath, FrameWriter::streamFormat(settings->outputFormat), 30);
+        frameWriter.startStream(&videoStream, 2 * writerThreads, firstFrame);
+    }
+    else
+        frameWriter.start(writerThreads, 2 * writerThreads, firstFrame);
+    frameWriter.setPngCompression(settings->pngCompression);
+    frameWriter.setPaletteReduction(settings->paletteFrames);
+
+    //The extra outputs go in the render folder, or next to the stream file
+    QString baseDirectory = filePath;
+    if (FrameWriter::isStreamFormat(settings->outputFormat))
+        baseDirectory = (filePath == "-") ? QDir::currentPath() : QFileInfo(filePath).absolutePath();
+    for (int i = 0; i < extraOutputs.size(); i++)
+        extraOutputs[i]->start(baseDirectory, writerThreads, 2 * writerThreads, firstFrame, *antCounter);
+
+    start();
+    return true;
+}
+
+
+
+
+
+//This function says whether the main output or any of the extra outputs is in one of the stream formats, which can
+//only be written from the start
+bool RenderPipeline::hasStreamOutput(const AntSettings * settings)
+{
+    if (FrameWriter::isStreamFormat(settings->outputFormat))
+        return true;
+    for (int i = 0; i < settings->extraOutputs.size(); i++)
+    {
+        if (FrameWriter::isStreamFormat(settings->extraOutputs[i].outputFormat))
+            return true;
+    }
+    return false;
+}
+
+
+
+
+
+//This function stops the render, throwing away any frames that haven't been saved yet, and waits for the threads to
+//finish.
+void RenderPipeline::stopRender()
+{
+    stopRequested = 1;
+    imageBlender->cancel();
+    frameWriter.cancel();
+    for (int i = 0; i < extraOutputs.size(); i++)
+        extraOutputs[i]->cancel();
+    wait();
+}
+
+
+
+
+
+//This function is called by the GUI thread when it receives the frameReady signal.
+QImage RenderPipeline::takeFrame(int * frameNumber, int * frameTime)
+{
+    QMutexLocker locker(&latestFrameMutex);
+
+    framePending = 0;
+
+    *frameNumber = latestFrameNumber;
+    *frameTime = latestFrameTime;
+    return latestFrame;
+}
+
+
+
+
+
+//This function sets where the camera is at the start of the next render, for a render that starts part way through an
+//animation that follows the pattern.  It only applies to one render.
+void RenderPipeline::setStartingCamera(const Camera & cameraP)
+{
+    startingCamera = cameraP;
+    startingCameraSet = true;
+}
+
+
+
+
+
+//This function has the pipeline save checkpoints as it goes: one for the start of every interval-th frame (1 +
+//interval, 1 + 2 * interval and so on, as the CLI's checkpoints command makes them) into directory.  simulation must be
+//the one the pipeline is rendering.  An interval of 0 turns them off.
+void RenderPipeline::setCheckpoints(AntSimulation * simulationP, const QString & directory, int interval)
+{
+    checkpointSimulation = simulationP;
+    checkpointDirectory = directory;
+    checkpointInterval = interval;
+}
+
+
+
+
+
+//This function sets how many threads save the frames of the next render, shared between the outputs.  Zero means one
+//less than the number of cores.
+void RenderPipeline::setWriterThreadCount(int count)
+{
+    writerThreadCount = count;
+}
+
+
+
+
+
+//This function returns how many frames have been saved in order from the first, by every output.  An output that has
+//fallen behind holds it back, as its frames are the ones a render carrying on from here would be missing.
+int RenderPipeline::framesWritten()
+{
+    int written = frameWriter.framesWrittenInOrder();
+    for (int i = 0; i < extraOutputs.size(); i++)
+        written = qMin(written, extraOutputs[i]->framesWritten());
+    return written;
+}
+
+int RenderPipeline::failedFrameCount()
+{
+    int failures = frameWriter.failedFrameCount();
+    for (int i = 0; i < extraOutputs.size(); i++)
+        failures += extraOutputs[i]->failedFrameCount();
+    return failures;
+}
+
+//This function says whether the last render ran all the way to the end, rather than being stopped.
+bool RenderPipeline::renderCompleted()
+{
+    return completed;
+}
+
+
+
+
+
+void RenderPipeline::run()
+{
+    previousFrame = QImage();
+    previousFrameMatchesGrid = false;
+
+    //The zero frame is just the grid as it is now.  It isn't blended, so it can be saved as a palette image made
+    //straight from the states.
+    if (firstFrame == 0)
+    {
+        gridMutex->lock();
+        QImage zeroFrame;
+        QImage indexedZeroFrame;
+        if (followPattern)
+        {
+            drawCameraView();
+            zeroFrame = cameraGrid->gridImage->copy();
+        }
+        else
+        {
+            zeroFrame = copyGridImage();
+            if (!FrameWriter::isStreamFormat(settings->outputFormat))
+                indexedZeroFrame = antGrid->makeIndexedImage();
+        }
+        gridMutex->unlock();
+
+        showFrame(zeroFrame, 0);
+        if (indexedZeroFrame.isNull())
+            frameWriter.write(zeroFrame, frameFileName(0), 0);
+        else
+            frameWriter.write(indexedZeroFrame, frameFileName(0), 0);
+
+        previousFrame = zeroFrame;
+        previousFrameMatchesGrid = true;
+
+        for (int i = 0; i < extraOutputs.size(); i++)
+            extraOutputs[i]->writeZeroFrame();
+    }
+
+    for (int frameNumber = qMax(1, firstFrame); frameNumber <= lastFrame; frameNumber++)
+    {
+        bool repeated;
+        bool outputsSkippedSamples;
+        QImage frame = makeFrame(&repeated, &outputsSkippedSamples);
+
+        //A null frame means the render was stopped
+        if (frame.isNull())
+            break;
+
+        showFrame(frame, frameNumber);
+
+        //This waits if the writer has fallen behind.  A frame that is the same as the last one isn't encoded again.
+        bool written;
+        if (repeated)
+            written = frameWriter.writeRepeat(frameFileName(frameNumber), frameNumber);
+        else
+            written = frameWriter.write(frame, frameFileName(frameNumber), frameNumber);
+        if (!written)
+            break;
+
+        //The extra outputs have had the same samples, so their frames are finished in the same way
+        for (int i = 0; i < extraOutputs.size(); i++)
+        {
+            if (outputsSkippedSamples)
+                extraOutputs[i]->finishUnchangedFrame(frameNumber);
+            else
+                extraOutputs[i]->finishFrame(frameNumber);
+        }
+
+        if ( (checkpointSimulation != 0)&&(checkpointInterval > 0)&&(frameNumber % checkpointInterval == 0)
+             &&(frameNumber < lastFrame) )
+            saveCheckpoint(frameNumber + 1);
+    }
+
+    gridMutex->lock();
+    antGrid->setChangeLogEnabled(false);
+    if (followPattern)
+        antGrid->setPyramidEnabled(pyramidWasEnabled);
+    gridMutex->unlock();
+
+    //Wait for the last frames to be saved, unless we were told to stop
+    if (!stopRequested)
+    {
+        frameWriter.finish();
+        for (int i = 0; i < extraOutputs.size(); i++)
+            extraOutputs[i]->finish();
+        completed = true;
+    }
+
+    //Give the frames' memory back until the next render
+    previousFrame = QImage();
+    framePool.clear();
+}
+
+
+
+
+
+//This function moves the ant through one frame's worth of samples and returns the blended frame.  repeated is set if
+//the frame is exactly the same as the one before, which happens once nothing on screen is changing: after the ant has
+//left the grid, or while it is in the hidden buffer around the edge.  The counter changes with every step, so frames
+//are only ever repeated if it is hidden.  samplesSkipped is set if no samples were made, so the extra outputs
+//have nothing to blend either.
+QImage RenderPipeline::makeFrame(bool * repeated, bool * samplesSkipped)
+{
+    *repeated = false;
+
+    //With a moving camera, every frame is different
+    if (followPattern)
+    {
+        *samplesSkipped = false;
+        return makeCameraFrame();
+    }
+
+    //Once the ant is out of range, moving it only advances the time, so there's no need to make or blend any samples
+    gridMutex->lock();
+    bool nothingCanChange = ( (antGrid->outOfRange)&&(!settings->showCounter) );
+    if (nothingCanChange)
+        antGrid->moveAnt(settings->samplesPerFrame * settings->stepsPerSample, true);
+    quint32 drawCountAtStart = displayGrid->drawCount;
+    gridMutex->unlock();
+
+    *samplesSkipped = nothingCanChange;
+    if (nothingCanChange)
+        return unchangedFrame(repeated);
+
+    for (int sample = 0; sample < settings->samplesPerFrame; sample++)
+    {
+        if (stopRequested)
+            return QImage();
+
+        QMutexLocker locker(gridMutex);
+
+        //Label the cells changed by this sample, if they are being logged
+        if ( (blendChangedCells)||(!extraOutputs.isEmpty()) )
+            antGrid->startChangeLogSample(sample);
+
+        antGrid->moveAnt(settings->stepsPerSample, true);
+
+        //If we are showing the counter or rules, draw them onto the image now
+        if ( (settings->showCounter)||(settings->showRules) )
+            antCounter->paintCountAndRules();
+
+        //Add the updated image to the blender.  The change blender only looks at the parts of the image that could
+        //have changed.
+        if (blendChangedCells)
+        {
+            QPoint antCell(antGrid->antX - settings->gridBuffer, antGrid->antY - settings->gridBuffer);
+            QRect overlayArea;
+            if ( (settings->showCounter)||(settings->showRules) )
+                overlayArea = antCounter->paintedArea;
+            changeBlender->addSample(*(displayGrid->gridImage), antGrid->changeLog, antCell, overlayArea);
+        }
+        else
+            imageBlender->addImage(*(displayGrid->gridImage), sample);
+
+        for (int i = 0; i < extraOutputs.size(); i++)
+            extraOutputs[i]->addSample(sample);
+    }
+
+    if (stopRequested)
+        return QImage();
+
+    //The blend has to be done either way, to get the blender ready for the next frame.  If every sample was the same
+    //as the grid at the start of the frame, though, the result is known.
+    QImage frame;
+    if (blendChangedCells)
+        frame = changeBlender->blendImages();
+    else
+        frame = imageBlender->blendImages();
+
+    gridMutex->lock();
+    bool gridChanged = ( (settings->showCounter)||(displayGrid->drawCount != drawCountAtStart) );
+    gridMutex->unlock();
+
+    //The blended frame isn't needed then, so its image goes straight back into the pool
+    if (!gridChanged)
+    {
+        framePool.release(frame);
+        return unchangedFrame(repeated);
+    }
+
+    previousFrame = frame;
+    previousFrameMatchesGrid = false;
+    return frame;
+}
+
+
+
+
+
+//This function returns the frame for when nothing has been drawn on the grid during it.  All of its samples are the
+//same as the grid image, so that is the frame, and if the last frame was also the grid image it is a repeat.
+QImage RenderPipeline::unchangedFrame(bool * repeated)
+{
+    if (previousFrameMatchesGrid)
+    {
+        *repeated = true;
+        return previousFrame;
+    }
+
+    gridMutex->lock();
+    previousFrame = copyGridImage();
+    gridMutex->unlock();
+
+    previousFrameMatchesGrid = true;
+    return previousFrame;
+}
+
+
+
+
+
+//This function makes a frame when the camera follows the pattern.  The camera moves once per frame, toward a view of
+//everything the ant has changed so far, and each sample is drawn from that view and blended in full.
+QImage RenderPipeline::makeCameraFrame()
+{
+    gridMutex->lock();
+    camera.follow(antGrid->contentBounds());
+    gridMutex->unlock();
+
+    for (int sample = 0; sample < settings->samplesPerFrame; sample++)
+    {
+        if (stopRequested)
+            return QImage();
+
+        QMutexLocker locker(gridMutex);
+
+        if (!extraOutputs.isEmpty())
+            antGrid->startChangeLogSample(sample);
+
+        antGrid->moveAnt(settings->stepsPerSample, true);
+        drawCameraView();
+        imageBlender->addImage(*(cameraGrid->gridImage), sample);
+
+        for (int i = 0; i < extraOutputs.size(); i++)
+            extraOutputs[i]->addSample(sample);
+    }
+
+    if (stopRequested)
+        return QImage();
+
+    return imageBlender->blendImages();
+}
+
+
+
+
+
+//This function draws the camera's view of the grid, and the counter and rules if they are showing, into the camera
+//grid's image.  The grid mutex must be held.
+void RenderPipeline::drawCameraView()
+{
+    antGrid->renderView(cameraGrid->gridImage, camera.firstColumn, camera.firstRow, camera.cellsPerPixel);
+    if ( (settings->showCounter)||(settings->showRules) )
+        cameraCounter->paintCountAndRules();
+}
+
+
+
+
+
+//This function saves a checkpoint for the start of frameNumber, which is where the grid is between frames.  When the
+//camera follows the pattern, the main counter isn't painted, so it takes the camera counter's box size first.  A
+//checkpoint that can't be saved only means a longer replay, so failures are ignored.  It is saved under a temporary
+//name first, so a render stopped part way through saving never leaves half a checkpoint behind.
+void RenderPipeline::saveCheckpoint(int frameNumber)
+{
+    QMutexLocker locker(gridMutex);
+
+    if (followPattern)
+        antCounter->copyBoxSize(*cameraCounter);
+
+    QString fileName = AntSimulation::checkpointFileName(checkpointDirectory, frameNumber);
+    QString temporaryFileName = fileName + ".part";
+    if (checkpointSimulation->saveCheckpoint(temporaryFileName, frameNumber, followPattern ? &camera : 0))
+    {
+        QFile::remove(fileName);
+        QFile::rename(temporaryFileName, fileName);
+    }
+    else
+        QFile::remove(temporaryFileName);
+}
+
+
+
+
+
+//This function copies the grid image into an image from the pool.  The grid mutex must be held.
+QImage RenderPipeline::copyGridImage()
+{
+    QImage * gridImage = displayGrid->gridImage;
+    QImage copy = framePool.lease();
+    if ( (copy.size() != gridImage->size())||(copy.format() != gridImage->format())||(copy.bytesPerLine() != gridImage->bytesPerLine()) )
+        return gridImage->copy();
+
+    memcpy(copy.bits(), gridImage->constBits(), gridImage->sizeInBytes());
+    return copy;
+}
+
+
+
+
+
+QString RenderPipeline::frameFileName(int frameNumber)
+{
+    return filePath + QDir::separator() + QString::number(frameNumber).rightJustified(5, '0') + "." + fileExtension;
+}
+
+
+
+
+
+//This function keeps the frame for the GUI and lets it know, unless it hasn't picked up the last one yet.
+void RenderPipeline::showFrame(const QImage & frame, int frameNumber)
+{
+    latestFrameMutex.lock();
+    latestFrame = frame;
+    latestFrameNumber = frameNumber;
+    latestFrameTime = settings->time;
+    latestFrameMutex.unlock();
+
+    if (framePending.testAndSetOrdered(0, 1))
+        emit frameReady();
+}
@@ -0,0 +1,129 @@
+#ifndef RENDERPIPELINE_H
+#define RENDERPIPELINE_H
+
+#include <QThread>
+#include <QMutex>
+#include <QImage>
+#include <QAtomicInt>
+
+#include "grid.h"
+#include "antgrid.h"
+#include "antsettings.h"
+#include "antcounter.h"
+#include "imageblender.h"
+#include "changeblender.h"
+#include "framewriter.h"
+#include "videostream.h"
+#include "framepool.h"
+#include "renderoutput.h"
+#include "camera.h"
+#include "antsimulation.h"
+
+//This class renders an animation to disk off the GUI thread.  The work is split into stages that overlap: this thread
+//moves the ant and blends the samples into frames (with the blending itself spread over the worker pool), and a
+//FrameWriter saves finished frames on its own threads.  The queue between them is bounded, so if saving falls behind
+//the simulation waits for it.  The GUI just picks up the latest frame with takeFrame to show progress.  With one of the
+//video stream formats, every frame goes into a single stream instead of a file of its own.  Any extra outputs in the
+//settings are drawn and saved alongside the main one from the same samples.  When the camera follows the pattern, the
+//main output is drawn from the camera's view of the whole grid instead of being a copy of the grid image.
+class RenderPipeline : public QThread
+{
+    Q_OBJECT
+
+public:
+    RenderPipeline(Grid * displayGridP, AntGrid * antGridP, AntCounter * antCounterP, AntSettings * settingsP, QMutex * gridMutexP);
+    ~RenderPipeline();
+
+    static bool hasStreamOutput(const AntSettings * settings);
+
+    bool startRender(const QString & filePathP, int firstFrameP = 0, int lastFrameP = -1);
+    void setStartingCamera(const Camera & cameraP);
+    void setCheckpoints(AntSimulation * simulationP, const QString & directory, int interval);
+    void setWriterThreadCount(int count);
+    void stopRender();
+    QImage takeFrame(int * frameNumber, int * frameTime);
+    int framesWritten();
+    int failedFrameCount();
+    bool renderCompleted();
+
+signals:
+    void frameReady();
+
+protected:
+    void run();
+
+private:
+    Grid * displayGrid;
+    AntGrid * antGrid;
+    AntCounter * antCounter;
+    AntSettings * settings;
+
+    //Shared with the GUI and the on-screen animation, to keep them off the grid while a sample is being made
+    QMutex * gridMutex;
+
+    ImageBlender * imageBlender;
+    ChangeBlender * changeBlender;
+    FrameWriter frameWriter;
+    VideoStream videoStream;
+
+    //The frames are leased from here by the blenders and handed back by the writer once they're saved
+    FramePool framePool;
+    QString filePath;
+    QString fileExtension;
+
+    //The number of threads saving frames, or 0 to choose from the number of cores
+    int writerThreadCount;
+
+    //The numbers of the first and last frames of the current render.  The first is only above 0 when a render carries
+    //on from part way, and the last is only below the frame count when a render is split into ranges.
+    int firstFrame;
+    int lastFrame;
+
+    //The extra outputs of the current (or last) render
+    QVector<RenderOutput *> extraOutputs;
+
+    //Whether the main output is blended by the change blender.  It can't be when the camera is moving.
+    bool blendChangedCells;
+
+    //When the camera follows the pattern, each sample is drawn from its view into this grid's image, which has the
+    //counter drawn on it by cameraCounter
+    bool followPattern;
+    Camera camera;
+    Camera startingCamera;
+    bool startingCameraSet;
+
+    //While these are set, a checkpoint of simulation is saved into checkpointDirectory for the start of every
+    //checkpointInterval-th frame, so a stopped render can carry on without replaying it all
+    AntSimulation * checkpointSimulation;
+    QString checkpointDirectory;
+    int checkpointInterval;
+    Grid * cameraGrid;
+    AntCounter * cameraCounter;
+    bool pyramidWasEnabled;
+
+    QAtomicInt stopRequested;
+    QAtomicInt framePending;
+    bool completed;
+
+    //The last frame made, and whether it is the same as the grid image.  If nothing is drawn on the grid during the
+    //next frame, that frame will be the same as the last one.
+    QImage previousFrame;
+    bool previousFrameMatchesGrid;
+
+    //The most recent frame, for the GUI to show
+    QMutex latestFrameMutex;
+    QImage latestFrame;
+    int latestFrameNumber;
+    int latestFrameTime;
+
+    QImage makeFrame(bool * repeated, bool * samplesSkipped);
+    QImage unchangedFrame(bool * repeated);
+    QImage makeCameraFrame();
+    void drawCameraView();
+    QImage copyGridImage();
+    QString frameFileName(int frameNumber);
+    void showFrame(const QImage & frame, int frameNumber);
+    void saveCheckpoint(int frameNumber);
+};
+
+#endif // RENDERPIPELINE_H
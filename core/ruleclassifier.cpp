@@ -0,0 +1,192 @@
+#include "ruleclassifier.h"
+#include <cmath>
+
+RuleClassifier::RuleClassifier(AntGrid * antGridP, AntSettings * settingsP)
+{
+    antGrid = antGridP;
+    settings = settingsP;
+
+    classification = growingClass;
+    classifiedTime = 0;
+    exitTime = 0;
+    exitedEarly = false;
+    period = 0;
+    spread = 0;
+}
+
+
+
+
+
+//This function moves the ant up to stepCount steps from the grid's current state, without drawing, and classifies
+//the pattern as it goes.  The classes are only looked for at the checks, so escapes and stopped growth are noticed up
+//to one check interval late.  Highways are found by their last few periods, so one that would later break up is
+//still called a highway, but a cycle is exact: when the ant's last period repeats the one before it, every cell it
+//touched has gone all the way round its states, so the grid is back where it was.
+void RuleClassifier::run(int stepCount)
+{
+    classification = growingClass;
+    classifiedTime = 0;
+    exitedEarly = false;
+    period = 0;
+    drift = QPoint();
+
+    int interval = settings->searchCheckInterval;
+    int maxPeriod = qMax(1, settings->searchMaxPeriod);
+    QRect lastBounds = antGrid->contentBounds();
+    int unchangedChecks = 0;
+    int stepsDone = 0;
+
+    if (interval <= 0)
+    {
+        antGrid->moveAntWithoutDrawing(stepCount);
+        stepsDone = stepCount;
+    }
+
+    while (stepsDone < stepCount)
+    {
+        int chunk = qMin(interval, stepCount - stepsDone);
+        antGrid->moveAntWithoutDrawing(chunk);
+        stepsDone += chunk;
+
+        //Once the ant is out of range nothing changes again, so the rest of the steps are only the time going on
+        if (antGrid->outOfRange)
+        {
+            if (classifyAndExit(escapedClass, stepsDone))
+                break;
+            antGrid->moveAntWithoutDrawing(stepCount - stepsDone);
+            stepsDone = stepCount;
+            break;
+        }
+
+        //A pattern that stays the same size for long enough is bounded, at least until it grows again
+        QRect bounds = antGrid->contentBounds();
+        if (bounds == lastBounds)
+            unchangedChecks++;
+        else
+            unchangedChecks = 0;
+        lastBounds = bounds;
+        if ( (classification == boundedClass)&&(unchangedChecks == 0) )
+        {
+            classification = growingClass;
+            classifiedTime = 0;
+        }
+        if ( (classification == growingClass)&&(settings->searchBoundedChecks > 0)
+             &&(unchangedChecks >= settings->searchBoundedChecks) )
+        {
+            if (classifyAndExit(boundedClass, stepsDone))
+                break;
+        }
+
+        //Look for a repeat, while there are enough steps left to trace one.  Highways and cycles don't stop being what
+        //they are, so there is no need to look again once one is found.
+        int window = 3 * maxPeriod;
+        if ( ( (classification == growingClass)||(classification == boundedClass) )&&(stepCount - stepsDone >= window) )
+        {
+            antGrid->setPathTraceEnabled(true);
+            antGrid->moveAntWithoutDrawing(window);
+            antGrid->setPathTraceEnabled(false);
+            stepsDone += window;
+
+            int found = classification;
+            checkForRepeats(maxPeriod);
+            if (classification != found)
+            {
+                int repeatClass = classification;
+                classification = found;
+                if (classifyAndExit(repeatClass, stepsDone))
+                    break;
+            }
+        }
+    }
+
+    //The ant can also leave during a trace at the very end
+    if ( (antGrid->outOfRange)&&(classification != escapedClass) )
+    {
+        classification = escapedClass;
+        classifiedTime = stepsDone;
+    }
+
+    exitTime = stepsDone;
+    QRect bounds = antGrid->contentBounds();
+    spread = (stepsDone > 0) ? qMax(bounds.width(), bounds.height()) / sqrt(double(stepsDone)) : 0;
+}
+
+
+
+
+
+//This function looks through the path trace for the shortest period of up to maxPeriod steps that the ant's last
+//two periods both repeat: the same states under the ant, the same directions and the same moves.  It sets the class
+//to highway or periodic if it finds one.
+void RuleClassifier::checkForRepeats(int maxPeriod)
+{
+    const QVector<AntStep> & trace = antGrid->pathTrace;
+    int length = trace.size();
+
+    //The ant has to have finished the trace in range, so where it ended up is known
+    if ( (antGrid->outOfRange)||(length == 0) )
+        return;
+
+    AntStep end;
+    end.x = antGrid->antX;
+    end.y = antGrid->antY;
+    end.direction = antGrid->antDirection;
+    end.state = 0;
+
+    for (int p = 1; (p <= maxPeriod)&&(3 * p <= length); p++)
+    {
+        int dx = end.x - trace[length - p].x;
+        int dy = end.y - trace[length - p].y;
+        if (end.direction != trace[length - p].direction)
+            continue;
+
+        bool repeats = true;
+        for (int i = length - 2 * p; (i < length)&&(repeats); i++)
+        {
+            const AntStep & now = trace[i];
+            const AntStep & before = trace[i - p];
+            repeats = ( (now.state == before.state)&&(now.direction == before.direction)
+                        &&(now.x - before.x == dx)&&(now.y - before.y == dy) );
+        }
+
+        if (repeats)
+        {
+            classification = ( (dx == 0)&&(dy == 0) ) ? periodicClass : highwayClass;
+            period = p;
+            drift = QPoint(dx, dy);
+            return;
+        }
+    }
+}
+
+
+
+
+
+//This function records a class found at the given time, and returns true if it is one the run should end at
+bool RuleClassifier::classifyAndExit(int classificationP, int time)
+{
+    classification = classificationP;
+    classifiedTime = time;
+    exitedEarly = settings->searchExits.contains(className(classificationP));
+    return exitedEarly;
+}
+
+//This function returns the name of a class, as used in settings files and search results
+QString RuleClassifier::className(int classificationP)
+{
+    switch (classificationP)
+    {
+    case escapedClass:
+        return "escaped";
+    case highwayClass:
+        return "highway";
+    case periodicClass:
+        return "periodic";
+    case boundedClass:
+        return "bounded";
+    default:
+        return "growing";
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef RULECLASSIFIER_H
+#define RULECLASSIFIER_H
+
+#include <QString>
+#include <QPoint>
+
+#include "antgrid.h"
+#include "antsettings.h"
+
+//This class runs the ant for a search and works out what kind of pattern it is making while it goes.  Every
+//settings->searchCheckInterval steps it checks whether the ant has left the grid, whether the pattern has stopped
+//growing, and whether the ant's last few thousand steps repeat: the same states, turns and moves over and over.  A
+//repeat that carries the ant along is a highway, and one that brings it back where it started is a cycle, which
+//goes on forever.  The run ends as soon as it finds one of the classes in settings->searchExits.
+class RuleClassifier
+{
+public:
+    enum Classification {growingClass = 0, escapedClass, highwayClass, periodicClass, boundedClass};
+
+    RuleClassifier(AntGrid * antGridP, AntSettings * settingsP);
+
+    void run(int stepCount);
+    static QString className(int classificationP);
+
+    //What the last run found.  classifiedTime is the step the class was noticed at (0 for growing) and exitTime is
+    //the number of steps that were run, which is less than asked for if the run ended early.  The period and drift
+    //(in cells per period) are set for highways and cycles, and spread is the size of the pattern over the square
+    //root of the time, which is roughly constant for a pattern growing like a random walk.
+    int classification;
+    int classifiedTime;
+    int exitTime;
+    bool exitedEarly;
+    int period;
+    QPoint drift;
+    double spread;
+
+private:
+    void checkForRepeats(int maxPeriod);
+    bool classifyAndExit(int classificationP, int time);
+
+    AntGrid * antGrid;
+    AntSettings * settings;
+};
+
+#endif // RULECLASSIFIER_H
@@ -0,0 +1,322 @@
+#include "rulesearch.h"
+#include <ctime>
+
+RuleSearch::RuleSearch()
+{
+    randNum.seed(quint64(time(NULL)));
+}
+
+
+
+
+
+void RuleSearch::seed(quint64 seedValue)
+{
+    randNum.seed(seedValue);
+}
+
+quint64 RuleSearch::seedValue()
+{
+    return randNum.seedValue();
+}
+
+
+
+
+
+//This function changes the settings that every search result is made with.  The ant starts in the middle, facing
+//up, and nothing is drawn over the pattern.
+void RuleSearch::prepareSettings(AntSettings * settings)
+{
+    //Move the starting position to the center
+    double visibleColumns = double(settings->pixelWidth) / double(settings->cellSize);
+    double visibleRows = double(settings->pixelHeight) / double(settings->cellSize);
+    settings->startingColumn = int(visibleColumns/2.0 + 0.5);
+    settings->startingRow = int(visibleRows/2.0 + 0.5);
+
+    //Make sure that the counter and rules are NOT displayed
+    settings->showCounter = false;
+    settings->showRules = false;
+
+    //Make sure the starting direction is up
+    settings->startingDirection = 0;
+
+    //Turn off the ant's color
+    settings->showAntColor = false;
+}
+
+
+
+
+
+//There isn't an integer power function in C++, so I had to make my own.
+quint64 RuleSearch::integerPower(quint64 x, int p)
+{
+    quint64 result = 1;
+    for (int i = 0; i < p; i++)
+        result *= x;
+    return result;
+}
+
+
+
+
+
+//This function returns the number of rules an "all" search goes through: every canonical rule.  It is only right for
+//up to maxStateCountForAll states.
+quint64 RuleSearch::patternCountForAll(int stateCount, bool includeBack)
+{
+    return canonicalCount(stateCount, includeBack);
+}
+
+
+
+
+
+//This function returns the most states a rule can have for every canonical rule to have a 64-bit index.  With U-turns
+//there are (3^n + 1)/2 canonical rules, which fits for up to 41 states, and without them there are 2^(n-1).
+int RuleSearch::maxStateCountForAll(bool includeBack)
+{
+    if (includeBack)
+        return 41;
+    return 64;
+}
+
+
+
+
+
+//This function returns a canonical rule's index, so that setSequentialRules(patternIndex(rules)) gives the same turns
+//back.  It is the number of canonical rules that come before it in the "all" search.
+quint64 RuleSearch::patternIndex(const StateRule * rules, int stateCount, bool includeBack)
+{
+    quint64 index = 0;
+    bool allBackSoFar = true;
+    int digitCount = includeBack ? 3 : 2;
+
+    for (int i = 0; i < stateCount; i++)
+    {
+        //Count the rules that have the same turns up to here and a turn that comes earlier for this state
+        for (int digit = 0; digit < digitCount; digit++)
+        {
+            AntDirection turn = turnForDigit(digit, includeBack);
+            if (turn == rules[i].direction)
+                break;
+            index += completionCount(turn, allBackSoFar, stateCount - i - 1, includeBack);
+        }
+
+        if (rules[i].direction != antBack)
+            allBackSoFar = false;
+    }
+
+    return index;
+}
+
+
+
+
+
+//This function returns the turn for a digit of an index.  The digits go R, B, L, or R, L without U-turns.
+AntDirection RuleSearch::turnForDigit(int digit, bool includeBack)
+{
+    if (digit == 0)
+        return antRight;
+    if ( (includeBack)&&(digit == 1) )
+        return antBack;
+    return antLeft;
+}
+
+
+
+
+
+//This function returns the number of canonical rules with the given number of states.  A canonical rule either
+//starts with R, after which anything goes, or starts with B and is followed by a shorter canonical rule.
+quint64 RuleSearch::canonicalCount(int length, bool includeBack)
+{
+    if (length <= 0)
+        return 1;
+    if (!includeBack)
+        return integerPower(2, length - 1);
+
+    quint64 count = 1;
+    for (int i = 0; i < length; i++)
+        count += integerPower(3, i);
+    return count;
+}
+
+
+
+
+
+//This function returns how many canonical rules start with the turns chosen so far followed by turn, with
+//remainingLength states still to come.  allBackSoFar is whether every turn chosen so far is a U-turn.
+quint64 RuleSearch::completionCount(AntDirection turn, bool allBackSoFar, int remainingLength, bool includeBack)
+{
+    if (!allBackSoFar)
+        return integerPower(includeBack ? 3 : 2, remainingLength);
+
+    //This is the first turn that isn't a U-turn, so it decides whether the rule is canonical
+    if (turn == antLeft)
+        return 0;
+    if (turn == antBack)
+        return canonicalCount(remainingLength, includeBack);
+    return integerPower(includeBack ? 3 : 2, remainingLength);
+}
+
+
+
+
+
+//This function checks to see if the first direction in the pattern is a left.  If so, it returns true, as the rule is
+//a mirror image of a canonical one.  For example, BRRL and BLLR are the same pattern, just mirror images.
+bool RuleSearch::startsWithLeft(const StateRule * rules, int stateCount)
+{
+    AntDirection firstDirection = antBack;
+    for (int i = 0; i < stateCount; i++) //loop through each state
+    {
+        if (rules[i].direction == antRight)
+        {
+            firstDirection = antRight;
+            break;
+        }
+        if (rules[i].direction == antLeft)
+        {
+            firstDirection = antLeft;
+            break;
+        }
+    }
+    if (firstDirection == antLeft)
+        return true;
+
+    return false;
+}
+
+
+
+
+
+//This function names a rule by its turns, e.g. "RLLR".  It is used for the names of saved files.
+QString RuleSearch::ruleName(const StateRule * rules, int stateCount)
+{
+    QString name = "";
+
+    for (int i=0; i<stateCount; i++)
+    {
+        switch (rules[i].direction)
+        {
+        case antRight:
+            name += "R";
+            break;
+        case antLeft:
+            name += "L";
+            break;
+        case antBack:
+            name += "B";
+            break;
+        }
+    }
+
+    return name;
+}
+
+
+
+
+
+QColor RuleSearch::randomColor()
+{
+    quint64 value = randNum.next();
+    return QColor(int(value & 0xFF), int((value >> 8) & 0xFF), int((value >> 16) & 0xFF));
+}
+
+
+
+
+
+//This function splits a search of patternCount indexes (or draws) into shardCount shards as evenly as it can, and
+//gives the range for shard number shard, which counts from 0.
+void RuleSearch::shardRange(quint64 patternCount, int shard, int shardCount, quint64 * firstPattern, quint64 * shardPatternCount)
+{
+    quint64 shardSize = patternCount / quint64(shardCount);
+    quint64 leftOver = patternCount % quint64(shardCount);
+
+    //The first leftOver shards get one extra
+    *firstPattern = quint64(shard) * shardSize + qMin(quint64(shard), leftOver);
+    *shardPatternCount = shardSize + ( (quint64(shard) < leftOver) ? 1 : 0 );
+}
+
+
+
+
+
+//This function picks a canonical rule at random, with every one equally likely.  drawNumber picks the generator's
+//stream, so the same draw always gives the same rule.  Nothing has to be thrown away: when the rules can be indexed, a
+//random index is picked, and otherwise the turns are picked at random and the rule is mirrored if it isn't canonical.
+//(That makes the all U-turn rule, which has no mirror image, half as likely as the others, but it is only one of more
+//than 3^41.)
+void RuleSearch::setRandomRules(StateRule * rules, int stateCount, bool includeBack, quint64 drawNumber)
+{
+    randNum.setStream(drawNumber);
+
+    if (stateCount <= maxStateCountForAll(includeBack))
+    {
+        setSequentialRules(rules, stateCount, includeBack, randNum.below(patternCountForAll(stateCount, includeBack)));
+        return;
+    }
+
+    int choiceCount = includeBack ? 3 : 2;
+    for (int i = 0; i < stateCount; i++)
+        rules[i] = StateRule(turnForDigit(int(randNum.below(choiceCount)), includeBack), randomColor());
+
+    if (startsWithLeft(rules, stateCount))
+    {
+        for (int i = 0; i < stateCount; i++)
+        {
+            if (rules[i].direction == antLeft)
+                rules[i].direction = antRight;
+            else if (rules[i].direction == antRight)
+                rules[i].direction = antLeft;
+        }
+    }
+
+    //State 1 is always white and state 2 is always black
+    rules[0].color = QColor(255,255,255);
+    rules[1].color = QColor(0,0,0);
+}
+
+
+
+
+
+//This function makes the canonical rule with the given index.  It is used when running an "all" search, which goes
+//through the indexes from 0 up to patternCountForAll.  The colors come from the index's own stream, so a rule always
+//gets the same colors from the same seed.
+void RuleSearch::setSequentialRules(StateRule * rules, int stateCount, bool includeBack, quint64 patternIndex)
+{
+    randNum.setStream(patternIndex);
+    bool allBackSoFar = true;
+    int digitCount = includeBack ? 3 : 2;
+
+    for (int i = 0; i < stateCount; i++)
+    {
+        //Skip past the rules that have an earlier turn for this state, until the index is among the ones that don't
+        AntDirection turn = antLeft;
+        for (int digit = 0; digit < digitCount; digit++)
+        {
+            turn = turnForDigit(digit, includeBack);
+            quint64 count = completionCount(turn, allBackSoFar, stateCount - i - 1, includeBack);
+            if (patternIndex < count)
+                break;
+            patternIndex -= count;
+        }
+
+        rules[i] = StateRule(turn, randomColor());
+        if (turn != antBack)
+            allBackSoFar = false;
+    }
+
+    //State 1 is always white and state 2 is always black
+    rules[0].color = QColor(255,255,255);
+    rules[1].color = QColor(0,0,0);
+}
@@ -0,0 +1,51 @@
+#ifndef RULESEARCH_H
+#define RULESEARCH_H
+
+#include <QString>
+
+#include "antsettings.h"
+#include "staterule.h"
+#include "counterrandom.h"
+
+//This class makes the rules tried by the pattern searches, for both the GUI and the command line.  An "all" search
+//goes through every rule for the number of states in order, and a random search picks them at random.  Either way,
+//state 1 is white, state 2 is black and the others get random colors.  Rules whose first turn (other than a U-turn)
+//is a left are mirror images of ones where it is a right, so the searches only make the canonical ones, where it is a
+//right.  Each canonical rule has an index: its place in the order the "all" search goes through them, which is the
+//order of the turns read as a number, with R before B before L and state 1 as the most significant.  The indexes are
+//64 bits, which is enough for every rule with up to maxStateCountForAll states.
+//
+//A search can be split into shards, each a range of indexes (or of draws, for a random search), that separate
+//processes go through.  Everything random comes from a counter-based generator, with a stream for each index or draw,
+//so given the same seed, a rule and its colors are always the same, whichever shard or thread makes them.
+class RuleSearch
+{
+public:
+    enum SearchType {allSearch = 1, randomSearch = 2};
+
+    RuleSearch();
+
+    static void prepareSettings(AntSettings * settings);
+    static quint64 integerPower(quint64 x, int p);
+    static quint64 patternCountForAll(int stateCount, bool includeBack);
+    static int maxStateCountForAll(bool includeBack);
+    static quint64 patternIndex(const StateRule * rules, int stateCount, bool includeBack);
+    static bool startsWithLeft(const StateRule * rules, int stateCount);
+    static QString ruleName(const StateRule * rules, int stateCount);
+    static void shardRange(quint64 patternCount, int shard, int shardCount, quint64 * firstPattern, quint64 * shardPatternCount);
+
+    void seed(quint64 seedValue);
+    quint64 seedValue();
+    void setRandomRules(StateRule * rules, int stateCount, bool includeBack, quint64 drawNumber);
+    void setSequentialRules(StateRule * rules, int stateCount, bool includeBack, quint64 patternIndex);
+
+private:
+    CounterRandom randNum;
+
+    QColor randomColor();
+    static AntDirection turnForDigit(int digit, bool includeBack);
+    static quint64 canonicalCount(int length, bool includeBack);
+    static quint64 completionCount(AntDirection turn, bool allBackSoFar, int remainingLength, bool includeBack);
+};
+
+#endif // RULESEARCH_H
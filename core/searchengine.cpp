@@ -0,0 +1,331 @@
+#include "searchengine.h"
+#include "antsimulation.h"
+#include "framewriter.h"
+#include "ruleclassifier.h"
+#include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+
+//Each of the engine's threads tries rules on its own simulation until there are none left
+class SearchWorkerThread : public QThread
+{
+public:
+    SearchWorkerThread(SearchEngine * engineP)
+    {
+        engine = engineP;
+    }
+
+protected:
+    void run()
+    {
+        //The simulation gets its own copy of the settings and rules, so the thread never touches anyone else's grid
+        AntSimulation simulation;
+        AntSettings * settings = &(simulation.settings);
+        *settings = engine->settings;
+        delete [] simulation.stateRules;
+        simulation.stateRules = new StateRule [settings->stateCount];
+        for (int i = 0; i < settings->stateCount; i++)
+            simulation.stateRules[i] = engine->startingRules[i];
+        simulation.create();
+
+        RuleClassifier classifier(simulation.antGrid, settings);
+        quint64 patternNumber;
+        while (engine->takeRule(simulation.stateRules, &patternNumber))
+        {
+            settings->time = 0;
+            simulation.antGrid->resetGrid();
+            classifier.run(settings->searchSteps);
+
+            //The image is made straight from the states when it can be, and otherwise drawn in full
+            QImage image = simulation.antGrid->makeIndexedImage();
+            if (image.isNull())
+            {
+                simulation.antGrid->drawAllSquares();
+                image = simulation.displayGrid->gridImage->copy();
+            }
+
+            SearchEngine::Result result;
+            result.patternNumber = patternNumber;
+            result.ruleName = RuleSearch::ruleName(simulation.stateRules, settings->stateCount);
+            result.fileName = engine->directory() + QDir::separator() + result.ruleName + "." + engine->fileExtension;
+            QString temporaryFileName = engine->directory() + QDir::separator() + result.ruleName + ".part"
+                                        + QString::number(patternNumber) + "." + engine->fileExtension;
+            result.saved = FrameWriter::saveImage(image, temporaryFileName, settings->pngCompression);
+            result.classification = classifier.classification;
+            result.classifiedTime = classifier.classifiedTime;
+            result.exitTime = classifier.exitTime;
+            result.period = classifier.period;
+            result.drift = classifier.drift;
+            result.spread = classifier.spread;
+
+            engine->ruleDone(result, image, temporaryFileName);
+        }
+
+        engine->threadFinished();
+    }
+
+private:
+    SearchEngine * engine;
+};
+
+
+
+
+
+SearchEngine::SearchEngine()
+{
+    runningThreads = 0;
+    stopping = false;
+    searchType = RuleSearch::randomSearch;
+    maxPatternCount = 0;
+    patternsHandedOut = 0;
+    firstPattern = 0;
+    nextSeed = 0;
+    nextSeedSet = false;
+    nextResult = 1;
+    failures = 0;
+    lastImagePattern = 0;
+}
+
+
+
+
+
+SearchEngine::~SearchEngine()
+{
+    stop();
+}
+
+
+
+
+
+//This function starts a search of searchTypeP (a RuleSearch::SearchType) with threadCount threads, saving an image of
+//each rule into directoryP.  rulesP holds settingsP.stateCount rules, whose colors are used where the search doesn't
+//choose them.  The search ends after maxPatternCountP rules, or for a random search, goes on until it is stopped if
+//that is 0.  The settings are changed in the same way as for any search (see RuleSearch::prepareSettings).  An "all"
+//search goes through the indexes from the first pattern on, and a random search makes the draws from the first
+//pattern on.
+void SearchEngine::start(const AntSettings & settingsP, const StateRule * rulesP, int searchTypeP, quint64 maxPatternCountP,
+                         const QString & directoryP, int threadCount)
+{
+    //Make sure any previous search is over
+    stop();
+
+    settings = settingsP;
+    RuleSearch::prepareSettings(&settings);
+    startingRules.clear();
+    for (int i = 0; i < settings.stateCount; i++)
+        startingRules.append(rulesP[i]);
+
+    //Search results are single images, so the video formats use PNG
+    fileExtension = FrameWriter::fileExtension(settings.outputFormat);
+    if ( (!FrameWriter::formatSupported(settings.outputFormat))||(FrameWriter::isStreamFormat(settings.outputFormat)) )
+        fileExtension = FrameWriter::fileExtension(FrameWriter::pngFormat);
+
+    searchType = searchTypeP;
+    maxPatternCount = maxPatternCountP;
+    searchDirectory = directoryP;
+    patternsHandedOut = 0;
+    finishedResults.clear();
+    nextResult = firstPattern + 1;
+    ruleSearch.seed(nextSeedSet ? nextSeed : QRandomGenerator::global()->generate64());
+    nextSeedSet = false;
+    failures = 0;
+    lastImage = QImage();
+    lastImagePattern = firstPattern;
+    stopping = false;
+
+    mutex.lock();
+    runningThreads = qMax(1, threadCount);
+    for (int i = 0; i < runningThreads; i++)
+    {
+        threads.append(new SearchWorkerThread(this));
+        threads.last()->start();
+    }
+    mutex.unlock();
+}
+
+
+
+
+
+//This function sets where the next search starts: the index of its first rule, or for a random search, the number
+//of its first draw
+void SearchEngine::setFirstPattern(quint64 firstPatternP)
+{
+    firstPattern = firstPatternP;
+}
+
+//This function sets the seed for the next search, so a random search (or the colors of an "all" search) can be made
+//again exactly
+void SearchEngine::setSeed(quint64 seedP)
+{
+    nextSeed = seedP;
+    nextSeedSet = true;
+}
+
+//This function returns the seed of the current (or last) search, or the one set for the next search if there is one.
+//A search that makes no rules is never started, but its seed is still the one it was given.
+quint64 SearchEngine::seed()
+{
+    if (nextSeedSet)
+        return nextSeed;
+    return ruleSearch.seedValue();
+}
+
+
+
+
+
+//This function stops the search, once the rules being tried now are done, and waits for the threads to finish.  Their
+//results can still be taken afterwards.
+void SearchEngine::stop()
+{
+    mutex.lock();
+    stopping = true;
+    QVector<QThread *> threadsToStop = threads;
+    threads.clear();
+    mutex.unlock();
+
+    for (int i = 0; i < threadsToStop.size(); i++)
+    {
+        threadsToStop[i]->wait();
+        delete threadsToStop[i];
+    }
+}
+
+
+
+
+
+//This function waits up to the given time for the search to finish.  It returns true if it has.
+bool SearchEngine::wait(unsigned long milliseconds)
+{
+    QMutexLocker locker(&mutex);
+
+    if (runningThreads > 0)
+        threadsDone.wait(&mutex, milliseconds);
+    return (runningThreads == 0);
+}
+
+bool SearchEngine::isRunning()
+{
+    QMutexLocker locker(&mutex);
+    return (runningThreads > 0);
+}
+
+
+
+
+
+//This function returns the results finished since the last call, in order.  A result whose rule came after one that
+//is still being tried waits until that one is done.
+QVector<SearchEngine::Result> SearchEngine::takeResults()
+{
+    QMutexLocker locker(&mutex);
+
+    QVector<Result> results;
+    while (finishedResults.contains(nextResult))
+        results.append(finishedResults.take(nextResult++));
+    return results;
+}
+
+//This function returns the image of the latest rule to be finished, to show how the search is going
+QImage SearchEngine::latestImage()
+{
+    QMutexLocker locker(&mutex);
+    return lastImage;
+}
+
+int SearchEngine::failedCount()
+{
+    QMutexLocker locker(&mutex);
+    return failures;
+}
+
+QString SearchEngine::directory()
+{
+    return searchDirectory;
+}
+
+//This function describes a result on one line of name=value pairs, for the CLI's output and the GUI's results file
+QString SearchEngine::describeResult(const Result & result)
+{
+    QString description = "pattern=" + QString::number(result.patternNumber)
+                          + " index=" + QString::number(result.patternNumber - 1)
+                          + " rule=" + result.ruleName
+                          + " class=" + RuleClassifier::className(result.classification)
+                          + " found=" + QString::number(result.classifiedTime)
+                          + " steps=" + QString::number(result.exitTime);
+    if (result.period > 0)
+        description += " period=" + QString::number(result.period)
+                       + " drift=" + QString::number(result.drift.x()) + "," + QString::number(result.drift.y());
+    description += " spread=" + QString::number(result.spread, 'f', 2) + " file=" + result.fileName;
+    return description;
+}
+
+
+
+
+
+//This function gives a thread the next rule to try, along with its pattern number.  It returns false when the search
+//is over.  Only canonical rules are made, so every one is used.
+bool SearchEngine::takeRule(StateRule * rules, quint64 * patternNumber)
+{
+    QMutexLocker locker(&mutex);
+
+    if ( (stopping)||( (maxPatternCount > 0)&&(patternsHandedOut >= maxPatternCount) ) )
+        return false;
+
+    quint64 patternIndex = firstPattern + patternsHandedOut;
+    if (searchType == RuleSearch::allSearch)
+        ruleSearch.setSequentialRules(rules, settings.stateCount, settings.includeBack, patternIndex);
+    else
+        ruleSearch.setRandomRules(rules, settings.stateCount, settings.includeBack, patternIndex);
+
+    patternsHandedOut++;
+    *patternNumber = patternIndex + 1;
+    return true;
+}
+
+
+
+
+
+//This function is called by a thread when it has saved a rule's image under temporaryFileName.  The file is given its
+//proper name, replacing any earlier image of the same rule.
+void SearchEngine::ruleDone(const Result & result, const QImage & image, const QString & temporaryFileName)
+{
+    QMutexLocker locker(&mutex);
+
+    Result finished = result;
+    if (finished.saved)
+    {
+        QFile::remove(finished.fileName);
+        finished.saved = QFile::rename(temporaryFileName, finished.fileName);
+    }
+    if (!finished.saved)
+    {
+        QFile::remove(temporaryFileName);
+        failures++;
+    }
+
+    if (result.patternNumber > lastImagePattern)
+    {
+        lastImage = image;
+        lastImagePattern = result.patternNumber;
+    }
+
+    finishedResults.insert(result.patternNumber, finished);
+}
+
+void SearchEngine::threadFinished()
+{
+    QMutexLocker locker(&mutex);
+
+    runningThreads--;
+    if (runningThreads == 0)
+        threadsDone.wakeAll();
+}
@@ -0,0 +1,99 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <QString>
+#include <QImage>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <QMap>
+#include <QThread>
+#include <QPoint>
+
+#include "antsettings.h"
+#include "staterule.h"
+#include "rulesearch.h"
+
+//This class runs a pattern search on a set of worker threads.  Each thread has a simulation of its own (settings,
+//rules, grids and images), so nothing is shared while the ant is moving, and each one saves the images it makes.  The
+//rules are handed out one at a time by a single RuleSearch, in the same order as a search on one thread would go
+//through them.  An image is saved under a temporary name and renamed once it is complete, so a file with a rule's
+//name is always a whole image.  The results are reported in the order the rules were handed out, whichever thread
+//finishes first.  A search can be one shard of a bigger one: it starts at firstPattern, and the pattern numbers it
+//reports are those of the whole search, so the results of the shards can be put together afterwards.
+class SearchEngine
+{
+public:
+    //One rule that has been tried.  The pattern numbers start at 1.  The rest is what the RuleClassifier found.
+    struct Result
+    {
+        quint64 patternNumber;
+        QString ruleName;
+        QString fileName;
+        bool saved;
+        int classification;
+        int classifiedTime;
+        int exitTime;
+        int period;
+        QPoint drift;
+        double spread;
+    };
+
+    SearchEngine();
+    ~SearchEngine();
+
+    void start(const AntSettings & settingsP, const StateRule * rulesP, int searchTypeP, quint64 maxPatternCountP,
+               const QString & directoryP, int threadCount);
+    void setFirstPattern(quint64 firstPatternP);
+    void setSeed(quint64 seedP);
+    quint64 seed();
+    void stop();
+    bool wait(unsigned long milliseconds);
+    bool isRunning();
+    QVector<Result> takeResults();
+    QImage latestImage();
+    int failedCount();
+    QString directory();
+    static QString describeResult(const Result & result);
+
+    //The threads call these to get work and report back
+    bool takeRule(StateRule * rules, quint64 * patternNumber);
+    void ruleDone(const Result & result, const QImage & image, const QString & temporaryFileName);
+    void threadFinished();
+
+    //The settings and rules every thread starts with, and the extension of the saved images.  They don't change while
+    //the search is running.
+    AntSettings settings;
+    QVector<StateRule> startingRules;
+    QString fileExtension;
+
+private:
+    QMutex mutex;
+    QWaitCondition threadsDone;
+    QVector<QThread *> threads;
+    int runningThreads;
+    bool stopping;
+
+    RuleSearch ruleSearch;
+    int searchType;
+    quint64 maxPatternCount;
+    quint64 patternsHandedOut;
+
+    //The index (or draw number) of the first rule, and the seed, for the next search.  The seed is only used once;
+    //otherwise each search gets a new one.
+    quint64 firstPattern;
+    quint64 nextSeed;
+    bool nextSeedSet;
+    QString searchDirectory;
+
+    //Results finished ahead of nextResult wait here until the ones before them are done
+    QMap<quint64, Result> finishedResults;
+    quint64 nextResult;
+    int failures;
+
+    //The image of the result reported last, for showing progress
+    QImage lastImage;
+    quint64 lastImagePattern;
+};
+
+#endif // SEARCHENGINE_H
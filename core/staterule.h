@@ -0,0 +1,22 @@
+#ifndef STATERULE_H
+#define STATERULE_H
+
+#include <QColor>
+#include "antdirection.h"
+
+//One state of the ant's rule: the color its cells are drawn in and the way the ant turns on them.  The simulation,
+//the counter and the settings only ever use these, so none of them need any widgets.  In the GUI, each StateWidget
+//keeps its StateRule up to date.
+struct StateRule
+{
+    StateRule(AntDirection directionP = antRight, QColor colorP = QColor(0, 0, 0))
+    {
+        direction = directionP;
+        color = colorP;
+    }
+
+    QColor color;
+    AntDirection direction;
+};
+
+#endif // STATERULE_H
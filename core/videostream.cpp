@@ -0,0 +1,243 @@
+#include "videostream.h"
+#include "blendkernels.h"
+#include "workerpool.h"
+#include <cstdio>
+
+VideoStream::VideoStream()
+{
+    streamFormat = y4mStream;
+    framesPerSecond = 30;
+    firstFrameNumber = 0;
+    file = 0;
+    deltaFile = 0;
+}
+
+
+
+
+
+VideoStream::~VideoStream()
+{
+    close();
+}
+
+
+
+
+
+//This function sets where the next stream will go.  The output isn't opened until the first frame arrives, as
+//opening a named pipe waits until something is reading from it.
+void VideoStream::setOutput(const QString & pathP, int streamFormatP, int framesPerSecondP)
+{
+    close();
+
+    path = pathP;
+    streamFormat = streamFormatP;
+    framesPerSecond = framesPerSecondP;
+    firstFrameNumber = 0;
+}
+
+//This function sets the number of the stream's first frame, which a packed delta file records
+void VideoStream::setFirstFrameNumber(int firstFrameNumberP)
+{
+    firstFrameNumber = firstFrameNumberP;
+}
+
+
+
+
+
+bool VideoStream::open(QSize size)
+{
+    frameSize = size;
+
+    //A keyframe every 10 seconds of video keeps random access quick without taking up much space
+    if (streamFormat == packedDeltaStream)
+    {
+        deltaFile = new DeltaFrameFile();
+        if (deltaFile->create(path, size, 10 * framesPerSecond, firstFrameNumber))
+            return true;
+
+        delete deltaFile;
+        deltaFile = 0;
+        return false;
+    }
+
+    file = new QFile();
+    bool opened;
+    if (path == "-")
+        opened = file->open(stdout, QIODevice::WriteOnly);
+    else
+    {
+        file->setFileName(path);
+        opened = file->open(QIODevice::WriteOnly);
+    }
+
+    if (!opened)
+    {
+        delete file;
+        file = 0;
+        return false;
+    }
+
+    //A YUV4MPEG2 stream starts with a header giving the size and frame rate.  The chroma samples are centered between
+    //the pixels they cover, which is what "420jpeg" means.
+    if (streamFormat == y4mStream)
+    {
+        QByteArray header = "YUV4MPEG2 W" + QByteArray::number(size.width()) + " H" + QByteArray::number(size.height())
+                            + " F" + QByteArray::number(framesPerSecond) + ":1 Ip A1:1 C420jpeg\n";
+        if (file->write(header) != header.size())
+        {
+            //Without its header the stream is no use, so don't let the frames go into it
+            delete file;
+            file = 0;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+
+
+//This function adds a frame to the stream.  All frames must be the same size as the first.
+bool VideoStream::writeFrame(const QImage & frame)
+{
+    if ( (file == 0)&&(deltaFile == 0) )
+    {
+        if (!open(frame.size()))
+            return false;
+    }
+
+    if (frame.size() != frameSize)
+        return false;
+
+    if (deltaFile != 0)
+        return deltaFile->appendFrame(frame);
+
+    QImage rgbFrame = frame;
+    if (rgbFrame.format() != QImage::Format_RGB32)
+        rgbFrame = rgbFrame.convertToFormat(QImage::Format_RGB32);
+
+    if (streamFormat == y4mStream)
+    {
+        convertToYuv420(rgbFrame);
+        if (file->write("FRAME\n", 6) != 6)
+            return false;
+    }
+    else
+        convertToRgb(rgbFrame);
+
+    return (file->write(frameData) == frameData.size());
+}
+
+
+
+
+
+//This function writes the last frame again.  The converted frame is kept, so nothing has to be converted, and a packed
+//delta frame file just marks the frame as unchanged.
+bool VideoStream::repeatFrame()
+{
+    if (deltaFile != 0)
+        return deltaFile->appendRepeatedFrame();
+
+    if (file == 0)
+        return false;
+
+    if (streamFormat == y4mStream)
+    {
+        if (file->write("FRAME\n", 6) != 6)
+            return false;
+    }
+
+    return (file->write(frameData) == frameData.size());
+}
+
+
+
+
+
+void VideoStream::close()
+{
+    if (deltaFile != 0)
+    {
+        deltaFile->finish();
+        delete deltaFile;
+        deltaFile = 0;
+    }
+
+    if (file == 0)
+        return;
+
+    file->close();
+    delete file;
+    file = 0;
+}
+
+
+
+
+
+//Raw RGB is just the red, green and blue bytes of each pixel, row after row
+void VideoStream::convertToRgb(const QImage & frame)
+{
+    int width = frame.width();
+    frameData.resize(width * frame.height() * 3);
+
+    uchar * output = reinterpret_cast<uchar *>(frameData.data());
+    const uchar * input = frame.constBits();
+    int bytesPerLine = frame.bytesPerLine();
+
+    WorkerPool::runInBands(frame.height(), [=](int firstRow, int lastRow)
+    {
+        for (int y = firstRow; y <= lastRow; y++)
+        {
+            const QRgb * line = reinterpret_cast<const QRgb *>(input + y * bytesPerLine);
+            uchar * outputLine = output + y * width * 3;
+            for (int x = 0; x < width; x++)
+            {
+                outputLine[3 * x] = uchar(qRed(line[x]));
+                outputLine[3 * x + 1] = uchar(qGreen(line[x]));
+                outputLine[3 * x + 2] = uchar(qBlue(line[x]));
+            }
+        }
+    });
+}
+
+
+
+
+
+//A 4:2:0 frame is the full-size Y plane followed by the U and V planes at half the width and height (rounded up).
+//Each pair of rows makes one row of U and V, so the work is split into bands of row pairs.
+void VideoStream::convertToYuv420(const QImage & frame)
+{
+    int width = frame.width();
+    int height = frame.height();
+    int chromaWidth = (width + 1) / 2;
+    int chromaHeight = (height + 1) / 2;
+    frameData.resize(width * height + 2 * chromaWidth * chromaHeight);
+
+    uchar * yPlane = reinterpret_cast<uchar *>(frameData.data());
+    uchar * uPlane = yPlane + width * height;
+    uchar * vPlane = uPlane + chromaWidth * chromaHeight;
+    const uchar * input = frame.constBits();
+    int bytesPerLine = frame.bytesPerLine();
+
+    WorkerPool::runInBands(chromaHeight, [=](int firstPair, int lastPair)
+    {
+        for (int pair = firstPair; pair <= lastPair; pair++)
+        {
+            int top = 2 * pair;
+            int bottom = qMin(top + 1, height - 1);
+
+            //An odd last row is paired with itself, and has no second row of Y values
+            BlendKernels::rgbToYuv420(input + top * bytesPerLine, input + bottom * bytesPerLine, width,
+                                      yPlane + top * width, (bottom != top) ? yPlane + bottom * width : 0,
+                                      uPlane + pair * chromaWidth, vPlane + pair * chromaWidth);
+        }
+    });
+}
@@ -0,0 +1,47 @@
+#ifndef VIDEOSTREAM_H
+#define VIDEOSTREAM_H
+
+#include <QImage>
+#include <QString>
+#include <QFile>
+#include <QByteArray>
+
+#include "deltaframefile.h"
+
+//This class writes frames one after another into a single uncompressed video stream, either raw 24-bit RGB or
+//YUV4MPEG2 (4:2:0).  The output can be a file, a named pipe, or standard output if the path is "-", so a render can be
+//fed straight into an encoder such as "x264 --demuxer y4m -" without any image files in between.  The stream can
+//also be a packed delta frame file, which has to be an ordinary file.
+class VideoStream
+{
+public:
+    enum StreamFormat {rawRgbStream = 0, y4mStream = 1, packedDeltaStream = 2};
+
+    VideoStream();
+    ~VideoStream();
+
+    void setOutput(const QString & pathP, int streamFormatP, int framesPerSecondP);
+    void setFirstFrameNumber(int firstFrameNumberP);
+    bool writeFrame(const QImage & frame);
+    bool repeatFrame();
+    void close();
+
+private:
+    QString path;
+    int streamFormat;
+    int framesPerSecond;
+    int firstFrameNumber;
+
+    QFile * file;
+    DeltaFrameFile * deltaFile;
+    QSize frameSize;
+
+    //The converted frame, kept from one frame to the next so it isn't reallocated
+    QByteArray frameData;
+
+    bool open(QSize size);
+    void convertToRgb(const QImage & frame);
+    void convertToYuv420(const QImage & frame);
+};
+
+#endif // VIDEOSTREAM_H
@@ -0,0 +1,150 @@
+#include "workerpool.h"
+#include <QSemaphore>
+#include <QThread>
+#include <QVector>
+
+//The number of threads each pass uses, including the calling thread.  Zero until it is first set or needed.
+static QAtomicInt chosenThreadCount;
+
+//The state shared by everything working on one pass
+class BandJob
+{
+public:
+    const std::function<void(int, int)> * work;
+    const QAtomicInt * cancelFlag;
+    int itemCount;
+    int bandCount;
+    QAtomicInt nextBand;
+    QAtomicInt cancelled;
+    QSemaphore helpersFinished;
+
+    //This function takes bands until there are none left or the pass is cancelled
+    void takeBands()
+    {
+        while (true)
+        {
+            if ( (cancelFlag != 0)&&(int(*cancelFlag) != 0) )
+            {
+                cancelled = 1;
+                return;
+            }
+
+            int band = nextBand.fetchAndAddOrdered(1);
+            if (band >= bandCount)
+                return;
+
+            //Spread the items evenly, so no band is more than one item bigger than another
+            int firstItem = int(qint64(itemCount) * band / bandCount);
+            int lastItem = int(qint64(itemCount) * (band + 1) / bandCount) - 1;
+            (*work)(firstItem, lastItem);
+        }
+    }
+};
+
+class BandHelper : public QRunnable
+{
+public:
+    BandHelper(BandJob * jobP)
+    {
+        job = jobP;
+        setAutoDelete(false);
+    }
+
+    void run()
+    {
+        job->takeBands();
+        job->helpersFinished.release();
+    }
+
+private:
+    BandJob * job;
+};
+
+
+
+
+
+//This function calls work(firstItem, lastItem) for bands of items covering 0 to itemCount-1, spread across the pool's
+//threads, and returns once they are all done.  work must be safe to call from several threads at once for different
+//bands.  If cancelFlag is given and becomes non-zero, no more bands are started and the function returns false.
+bool WorkerPool::runInBands(int itemCount, const std::function<void(int, int)> & work, const QAtomicInt * cancelFlag)
+{
+    if (itemCount <= 0)
+        return true;
+
+    BandJob job;
+    job.work = &work;
+    job.cancelFlag = cancelFlag;
+    job.itemCount = itemCount;
+    job.nextBand = 0;
+    job.cancelled = 0;
+
+    //Several bands per thread, so a thread that gets a quick band can pick up another one
+    int threads = threadCount();
+    job.bandCount = qMin(itemCount, threads * 4);
+
+    //With one thread, or only one band, just do the work here
+    QVector<BandHelper *> helpers;
+    int helperCount = qMin(threads - 1, job.bandCount - 1);
+    for (int i = 0; i < helperCount; i++)
+    {
+        helpers.append(new BandHelper(&job));
+        pool()->start(helpers.last());
+    }
+
+    job.takeBands();
+
+    //Helpers that never got a thread (because the pool was busy) are taken back rather than waited for.  This also
+    //means that a pass started from inside another pass can't get stuck waiting on itself.
+    int helpersToWaitFor = 0;
+    for (int i = 0; i < helpers.size(); i++)
+    {
+        if (!pool()->tryTake(helpers[i]))
+            helpersToWaitFor++;
+    }
+    job.helpersFinished.acquire(helpersToWaitFor);
+
+    for (int i = 0; i < helpers.size(); i++)
+        delete helpers[i];
+
+    return (int(job.cancelled) == 0);
+}
+
+
+
+
+
+int WorkerPool::threadCount()
+{
+    if (int(chosenThreadCount) == 0)
+        setThreadCount(0);
+    return int(chosenThreadCount);
+}
+
+
+
+
+
+//This function sets the number of threads used by each pass, including the calling thread.  A count of zero or less
+//means one per core.
+void WorkerPool::setThreadCount(int count)
+{
+    if (count <= 0)
+        count = QThread::idealThreadCount();
+    count = qMax(1, count);
+
+    //The calling thread does work too, so the pool needs one thread fewer
+    pool()->setMaxThreadCount(qMax(1, count - 1));
+    chosenThreadCount = count;
+}
+
+
+
+
+
+QThreadPool * WorkerPool::pool()
+{
+    //This is made the first time it is needed and kept until the program ends
+    static QThreadPool * threadPool = new QThreadPool();
+    return threadPool;
+}
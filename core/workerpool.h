@@ -0,0 +1,22 @@
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <functional>
+
+//This class runs the per-pixel and per-row passes (blending, redrawing the grid and so on) on all of the CPU's cores.
+//A pass is split into bands of consecutive items, usually rows of an image, which the pool's threads and the calling
+//thread take one at a time until none are left.  All passes share one set of threads.
+class WorkerPool
+{
+public:
+    static bool runInBands(int itemCount, const std::function<void(int, int)> & work, const QAtomicInt * cancelFlag = 0);
+    static int threadCount();
+    static void setThreadCount(int count);
+
+private:
+    static QThreadPool * pool();
+};
+
+#endif // WORKERPOOL_H
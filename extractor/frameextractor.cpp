@@ -0,0 +1,81 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QDir>
+
+#include "deltaframefile.h"
+#include "videostream.h"
+
+//This program extracts frames from a packed delta frame file made by the animator.  Usage:
+//
+//  frameextractor <input.antframes> <output> [first frame] [last frame]
+//
+//If the output ends in .y4m, or is "-" for standard output, the frames are written as a Y4M video at 30 frames per
+//second.  Otherwise it is a directory, and each frame is saved in it as a PNG named after its frame number.  Frames
+//are numbered as the render numbered them, from 0 if it saved the zero frame and from 1 if not, so the PNGs have the
+//same names as a PNG render's would.  By default all of them are extracted.
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QStringList arguments = a.arguments();
+    QTextStream errorStream(stderr);
+
+    if ( (arguments.size() < 3)||(arguments.size() > 5) )
+    {
+        errorStream << "Usage: frameextractor <input.antframes> <output directory | output.y4m | -> [first frame] [last frame]" << Qt::endl;
+        return 1;
+    }
+
+    DeltaFrameFile input;
+    if (!input.open(arguments[1]))
+    {
+        errorStream << "Couldn't read " << arguments[1] << Qt::endl;
+        return 1;
+    }
+
+    int numberOffset = input.firstFrameNumber();
+    int firstFrame = numberOffset;
+    int lastFrame = numberOffset + input.frameCount() - 1;
+    if (arguments.size() > 3)
+        firstFrame = qMax(numberOffset, arguments[3].toInt());
+    if (arguments.size() > 4)
+        lastFrame = qMin(lastFrame, arguments[4].toInt());
+
+    QString output = arguments[2];
+    bool videoOutput = ( (output == "-")||(output.endsWith(".y4m", Qt::CaseInsensitive)) );
+
+    VideoStream videoStream;
+    if (videoOutput)
+        videoStream.setOutput(output, VideoStream::y4mStream, 30);
+    else if (!QDir().mkpath(output))
+    {
+        errorStream << "Couldn't make the directory " << output << Qt::endl;
+        return 1;
+    }
+
+    for (int i = firstFrame; i <= lastFrame; i++)
+    {
+        QImage frame = input.readFrame(i - numberOffset);
+        if (frame.isNull())
+        {
+            errorStream << "Couldn't read frame " << i << Qt::endl;
+            return 1;
+        }
+
+        bool succeeded;
+        if (videoOutput)
+            succeeded = videoStream.writeFrame(frame);
+        else
+            succeeded = frame.save(output + QDir::separator() + QString::number(i).rightJustified(5, '0') + ".png");
+
+        if (!succeeded)
+        {
+            errorStream << "Couldn't write frame " << i << Qt::endl;
+            return 1;
+        }
+    }
+
+    videoStream.close();
+    return 0;
+}
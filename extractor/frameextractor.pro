@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Command line tool that turns a packed delta frame file back into PNG images or a Y4M video.
+#
+#-------------------------------------------------
+
+QT       += core gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = frameextractor
+TEMPLATE = app
+
+include(../core/core.pri)
+
+SOURCES += frameextractor.cpp
@@ -0,0 +1,42 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2012-06-14T19:38:49
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+CONFIG += c++11
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = Langtons_Ant
+TEMPLATE = app
+
+include(../core/core.pri)
+
+SOURCES += main.cpp\
+        mainwindow.cpp \
+    statewidget.cpp \
+    searchdialog.cpp \
+    simulationthread.cpp \
+    jobqueuedialog.cpp
+
+HEADERS  += mainwindow.h \
+    statewidget.h \
+    searchdialog.h \
+    simulationthread.h \
+    jobqueuedialog.h
+
+FORMS    += mainwindow.ui \
+    statewidget.ui \
+    searchdialog.ui \
+    jobqueuedialog.ui
+
+RESOURCES += \
+    images.qrc
+
+
+unix:QMAKE_CXXFLAGS += -std=c++11
+
+win32:RC_FILE = myapp.rc
+macx:ICON = application.icns
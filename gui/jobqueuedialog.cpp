@@ -0,0 +1,167 @@
+#include "jobqueuedialog.h"
+#include "ui_jobqueuedialog.h"
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QMessageBox>
+#include <QDir>
+
+JobQueueDialog::JobQueueDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::JobQueueDialog)
+{
+    ui->setupUi(this);
+
+    ui->coreBudgetSpinBox->setValue(queue.coreBudget);
+    ui->memoryBudgetSpinBox->setValue(int(queue.memoryBudget / (1024 * 1024)));
+    ui->jobTable->horizontalHeader()->setStretchLastSection(true);
+
+    connect(ui->addButton, SIGNAL(clicked()), this, SLOT(addJobs()));
+    connect(ui->removeButton, SIGNAL(clicked()), this, SLOT(removeJob()));
+    connect(ui->loadButton, SIGNAL(clicked()), this, SLOT(loadQueue()));
+    connect(ui->saveButton, SIGNAL(clicked()), this, SLOT(saveQueue()));
+    connect(ui->startButton, SIGNAL(clicked()), this, SLOT(startQueue()));
+    connect(ui->stopButton, SIGNAL(clicked()), this, SLOT(stopQueue()));
+    connect(ui->closeButton, SIGNAL(clicked()), this, SLOT(hide()));
+    connect(ui->memoryBudgetSpinBox, SIGNAL(valueChanged(int)), this, SLOT(budgetChanged()));
+    connect(ui->coreBudgetSpinBox, SIGNAL(valueChanged(int)), this, SLOT(budgetChanged()));
+    connect(&updateTimer, SIGNAL(timeout()), this, SLOT(updateQueue()));
+
+    ui->stopButton->setEnabled(false);
+    updateTable();
+}
+
+JobQueueDialog::~JobQueueDialog()
+{
+    delete ui;
+}
+
+
+
+
+//This function asks for some settings files and a directory, and adds a job for each file.  The frames of each job go
+//into a folder (or stream file) in the directory named after its settings file.
+void JobQueueDialog::addJobs()
+{
+    QStringList settingsFiles = QFileDialog::getOpenFileNames(this, "Settings to Render", "", "Langton's Ant Settings (*.las)");
+    if (settingsFiles.isEmpty())
+        return;
+
+    QString outputDirectory = QFileDialog::getExistingDirectory(this, tr("Directory to Save Renders"), "", QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks);
+    if (outputDirectory == "")
+        return;
+
+    for (int i = 0; i < settingsFiles.size(); i++)
+        queue.addJob(settingsFiles[i], outputDirectory + QDir::separator() + QFileInfo(settingsFiles[i]).completeBaseName());
+
+    updateTable();
+}
+
+
+
+
+void JobQueueDialog::removeJob()
+{
+    queue.removeJob(ui->jobTable->currentRow());
+    updateTable();
+}
+
+
+
+
+void JobQueueDialog::loadQueue()
+{
+    QString fileName = QFileDialog::getOpenFileName(this, "Load Queue", "", "Render Queue (*.txt)");
+    if (fileName == "")
+        return;
+
+    stopQueue();
+    if (!queue.loadState(fileName))
+        QMessageBox::warning(this, "Queue error", "The queue could not be loaded.");
+    updateTable();
+}
+
+
+
+
+void JobQueueDialog::saveQueue()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "Save Queue", "", "Render Queue (*.txt)");
+    if (fileName == "")
+        return;
+
+    if (!queue.saveState(fileName))
+        QMessageBox::warning(this, "Queue error", "The queue could not be saved.");
+}
+
+
+
+
+void JobQueueDialog::startQueue()
+{
+    queue.start();
+    updateTimer.start(500);
+    ui->startButton->setEnabled(false);
+    ui->stopButton->setEnabled(true);
+    ui->loadButton->setEnabled(false);
+    updateQueue();
+}
+
+
+
+
+//This function stops the running jobs.  They carry on from where they got to when the queue is started again.
+void JobQueueDialog::stopQueue()
+{
+    updateTimer.stop();
+    queue.stop();
+    ui->startButton->setEnabled(true);
+    ui->stopButton->setEnabled(false);
+    ui->loadButton->setEnabled(true);
+    updateTable();
+}
+
+
+
+
+void JobQueueDialog::budgetChanged()
+{
+    queue.setBudget(qint64(ui->memoryBudgetSpinBox->value()) * 1024 * 1024, ui->coreBudgetSpinBox->value());
+}
+
+
+
+
+void JobQueueDialog::updateQueue()
+{
+    queue.update();
+    updateTable();
+
+    if (queue.isFinished())
+        stopQueue();
+}
+
+
+
+
+void JobQueueDialog::updateTable()
+{
+    ui->jobTable->setRowCount(queue.jobs.size());
+    for (int i = 0; i < queue.jobs.size(); i++)
+    {
+        RenderJob * job = queue.jobs[i];
+        QString status = RenderJob::statusName(job->status);
+        if (!job->message.isEmpty())
+            status += ": " + job->message;
+
+        ui->jobTable->setItem(i, 0, new QTableWidgetItem(QFileInfo(job->settingsFile).fileName()));
+        ui->jobTable->setItem(i, 1, new QTableWidgetItem(job->renderPath()));
+        ui->jobTable->setItem(i, 2, new QTableWidgetItem(status));
+        ui->jobTable->setItem(i, 3, new QTableWidgetItem(QString::number(job->framesDone) + " / " + QString::number(job->frameTotal)));
+        ui->jobTable->setItem(i, 4, new QTableWidgetItem(QString::number(job->memoryNeeded / (1024 * 1024))));
+        ui->jobTable->setItem(i, 5, new QTableWidgetItem(QString::number(job->coresNeeded)));
+    }
+
+    ui->summaryLabel->setText(QString::number(queue.jobCount(RenderJob::runningJob)) + " running, "
+                              + QString::number(queue.memoryInUse() / (1024 * 1024)) + " MB and "
+                              + QString::number(queue.coresInUse()) + " cores in use");
+}
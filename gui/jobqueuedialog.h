@@ -0,0 +1,44 @@
+#ifndef JOBQUEUEDIALOG_H
+#define JOBQUEUEDIALOG_H
+
+#include <QtWidgets/QDialog>
+#include <QTimer>
+
+#include "jobqueue.h"
+
+namespace Ui {
+class JobQueueDialog;
+}
+
+//This dialog shows the render queue and lets the user add jobs to it and start and stop it.  The queue keeps running
+//while the dialog is hidden.
+class JobQueueDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit JobQueueDialog(QWidget *parent);
+    ~JobQueueDialog();
+
+private:
+    Ui::JobQueueDialog *ui;
+
+    JobQueue queue;
+
+    //Calls the queue's update function while it is running
+    QTimer updateTimer;
+
+    void updateTable();
+
+private slots:
+    void addJobs();
+    void removeJob();
+    void loadQueue();
+    void saveQueue();
+    void startQueue();
+    void stopQueue();
+    void budgetChanged();
+    void updateQueue();
+};
+
+#endif // JOBQUEUEDIALOG_H
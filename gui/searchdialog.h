@@ -1,29 +1,32 @@
-#ifndef SEARCHDIALOG_H
-#define SEARCHDIALOG_H
-
-#include <QtWidgets/QDialog>
-
-namespace Ui {
-class SearchDialog;
-}
-
-class SearchDialog : public QDialog
-{
-    Q_OBJECT
-    
-public:
-    explicit SearchDialog(QWidget *parent, int searchType, int maxPatternCount);
-    ~SearchDialog();
-    void updatePatternCount(int newPatternCount);
-    
-private:
-    Ui::SearchDialog *ui;
-
-private slots:
-    void cancelButtonPushed();
-
-signals:
-    void cancelSearch();
-};
-
-#endif // SEARCHDIALOG_H
+#ifndef SEARCHDIALOG_H
+#define SEARCHDIALOG_H
+
+#include <QtWidgets/QDialog>
+
+namespace Ui {
+class SearchDialog;
+}
+
+class SearchDialog : public QDialog
+{
+    Q_OBJECT
+    
+public:
+    explicit SearchDialog(QWidget *parent, int searchType, quint64 maxPatternCountP);
+    ~SearchDialog();
+    void updatePatternCount(quint64 newPatternCount);
+    
+private:
+    Ui::SearchDialog *ui;
+
+    //The progress bar only goes up to an int, so it shows thousandths of this
+    quint64 maxPatternCount;
+
+private slots:
+    void cancelButtonPushed();
+
+signals:
+    void cancelSearch();
+};
+
+#endif // SEARCHDIALOG_H
@@ -0,0 +1,238 @@
+#include "simulationthread.h"
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <cstring>
+
+SimulationThread::SimulationThread(Grid * displayGridP, AntGrid * antGridP, AntCounter * antCounterP, AntSettings * settingsP)
+{
+    //Store the pointers to the objects that the thread will be working on
+    displayGrid = displayGridP;
+    antGrid = antGridP;
+    antCounter = antCounterP;
+    settings = settingsP;
+
+    frontBuffer = 0;
+    frameTimes[0] = 0;
+    frameTimes[1] = 0;
+    measuredStepsPerSecond = 0.0;
+
+    updatePlaybackSettings();
+}
+
+
+
+
+
+SimulationThread::~SimulationThread()
+{
+    //The thread must not be running when it is destroyed
+    stopPlayback();
+}
+
+
+
+
+
+void SimulationThread::startPlayback()
+{
+    //Quit if the thread is already going
+    if (isRunning())
+        return;
+
+    stopRequested = 0;
+    framePending = 0;
+    measuredStepsPerSecond = 0.0;
+
+    //The first frame uses the user's steps per update.  In target FPS mode this is then adjusted up or down once
+    //the speed of the simulation has been measured.
+    updatePlaybackSettings();
+    stepsPerFrame = int(stepsPerUpdate);
+
+    start();
+}
+
+
+
+
+
+//This function asks the thread to stop and then waits for it to do so.  Once it returns, the GUI thread is free to
+//work on the Grid and AntGrid objects again.
+void SimulationThread::stopPlayback()
+{
+    stopRequested = 1;
+    wait();
+}
+
+
+
+
+
+//This function copies the playback settings into atomic members so the simulation thread can safely read them.  It
+//should be called whenever one of them changes.
+void SimulationThread::updatePlaybackSettings()
+{
+    stepsPerUpdate = settings->stepsPerUpdate;
+    delayPerUpdate = settings->delayPerUpdate;
+    targetFpsPlayback = settings->targetFpsPlayback;
+    targetFps = settings->targetFps;
+}
+
+
+
+
+
+//This function is called by the GUI thread when it receives the frameReady signal.  It returns the most recent image
+//and the time at which it was made.
+QImage SimulationThread::takeFrame(int * frameTime)
+{
+    QMutexLocker locker(&bufferMutex);
+
+    //Let the simulation thread know that it can signal again
+    framePending = 0;
+
+    *frameTime = frameTimes[frontBuffer];
+    return frameBuffers[frontBuffer];
+}
+
+
+
+
+
+int SimulationThread::currentStepsPerFrame()
+{
+    return int(stepsPerFrame);
+}
+
+
+
+
+
+void SimulationThread::run()
+{
+    QElapsedTimer frameTimer;
+    QElapsedTimer kernelTimer;
+    qint64 kernelNanoseconds;
+    int stepCount;
+    bool outOfRange;
+
+    while (!stopRequested)
+    {
+        frameTimer.start();
+        stepCount = chooseStepCount();
+
+        //Move the ant and copy the result into the back buffer.  The grid mutex is only held for this part so the GUI
+        //can get in between updates if it needs to redraw something.
+        gridMutex.lock();
+
+        kernelTimer.start();
+        antGrid->moveAnt(stepCount, true);
+        kernelNanoseconds = kernelTimer.nsecsElapsed();
+
+        //If we are showing the counter or rules, draw them onto the image now
+        if ( (settings->showCounter)||(settings->showRules) )
+            antCounter->paintCountAndRules();
+
+        copyToBackBuffer();
+        outOfRange = antGrid->outOfRange;
+
+        gridMutex.unlock();
+
+        //Keep a smoothed measure of how many steps the simulation can do per second.  This is what target FPS mode
+        //uses to decide how many steps to take per frame.
+        if ( (kernelNanoseconds > 0)&&(!outOfRange) )
+        {
+            double latestStepsPerSecond = double(stepCount) * 1.0e9 / double(kernelNanoseconds);
+            if (measuredStepsPerSecond == 0.0)
+                measuredStepsPerSecond = latestStepsPerSecond;
+            else
+                measuredStepsPerSecond = 0.8 * measuredStepsPerSecond + 0.2 * latestStepsPerSecond;
+        }
+
+        //Swap the buffers so the new image is at the front
+        bufferMutex.lock();
+        frontBuffer = 1 - frontBuffer;
+        bufferMutex.unlock();
+
+        //Only signal the GUI if it has picked up the last frame.  This keeps the event queue from filling up when the
+        //simulation is faster than the screen.  The GUI always takes the newest frame, so nothing is lost.
+        if (framePending.testAndSetOrdered(0, 1))
+            emit frameReady();
+
+        //The simulation is over once the ant leaves the grid
+        if (outOfRange)
+            break;
+
+        if (targetFpsPlayback)
+        {
+            //In target FPS mode, sleep for whatever is left of this frame's time slot.
+            qint64 frameNanoseconds = 1000000000LL / qMax(1, int(targetFps));
+            qint64 remainingNanoseconds = frameNanoseconds - frameTimer.nsecsElapsed();
+            if (remainingNanoseconds > 0)
+                usleep(remainingNanoseconds / 1000);
+        }
+        else
+        {
+            //In the normal mode, each displayed frame is exactly one update, so wait until the GUI has shown this one
+            //before making the next.  The user's delay is then added on top of that.
+            while ( (framePending)&&(!stopRequested) )
+                usleep(500);
+            for (int i = 0; (i < int(delayPerUpdate))&&(!stopRequested); i++)
+                msleep(1);
+        }
+    }
+}
+
+
+
+
+
+//This function decides how many steps to take for the next frame.
+int SimulationThread::chooseStepCount()
+{
+    //In the normal mode, this is just the user's setting
+    if ( (!targetFpsPlayback)||(measuredStepsPerSecond == 0.0) )
+    {
+        if (!targetFpsPlayback)
+            stepsPerFrame = int(stepsPerUpdate);
+        return int(stepsPerFrame);
+    }
+
+    //In target FPS mode, take as many steps as the simulation can manage in 80% of a frame's time.  The other 20%
+    //is left for painting the counter and copying the image.
+    double frameSeconds = 1.0 / double(qMax(1, int(targetFps)));
+    double idealSteps = measuredStepsPerSecond * frameSeconds * 0.8;
+
+    //Don't let the step count grow too quickly, in case a measurement was off
+    int previousSteps = int(stepsPerFrame);
+    if (idealSteps > 2.0 * previousSteps)
+        idealSteps = 2.0 * previousSteps;
+    if (idealSteps > 1.0e9)
+        idealSteps = 1.0e9;
+    if (idealSteps < 1.0)
+        idealSteps = 1.0;
+
+    stepsPerFrame = int(idealSteps);
+    return int(stepsPerFrame);
+}
+
+
+
+
+
+//This function copies the grid's image into the back buffer and records the time that goes with it.  The buffer is
+//reused from frame to frame so no memory is allocated unless the image size changes.  If the whole grid is being
+//viewed, the zoomed-out image is drawn into the buffer instead.
+void SimulationThread::copyToBackBuffer()
+{
+    int backBuffer = 1 - frontBuffer;
+    QImage * gridImage = displayGrid->gridImage;
+
+    if ( (frameBuffers[backBuffer].size() != gridImage->size())||(frameBuffers[backBuffer].format() != gridImage->format()) )
+        frameBuffers[backBuffer] = QImage(gridImage->size(), gridImage->format());
+
+    if (antGrid->pyramidEnabled())
+        antGrid->renderWholeGrid(&frameBuffers[backBuffer]);
+    else
+        memcpy(frameBuffers[backBuffer].bits(), gridImage->constBits(), gridImage->sizeInBytes());
+    frameTimes[backBuffer] = settings->time;
+}
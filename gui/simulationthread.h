@@ -0,0 +1,69 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QImage>
+#include <QAtomicInt>
+
+#include "grid.h"
+#include "antgrid.h"
+#include "antsettings.h"
+#include "antcounter.h"
+
+//This class runs the on-screen animation on its own thread so the GUI stays responsive no matter how many steps are
+//taken per update.  Finished images are handed to the GUI through a pair of buffers: the thread fills the back buffer
+//and then swaps it to the front, where the GUI can pick it up with takeFrame.
+class SimulationThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    SimulationThread(Grid * displayGridP, AntGrid * antGridP, AntCounter * antCounterP, AntSettings * settingsP);
+    ~SimulationThread();
+
+    void startPlayback();
+    void stopPlayback();
+    void updatePlaybackSettings();
+    QImage takeFrame(int * frameTime);
+    int currentStepsPerFrame();
+
+    //This mutex must be held by anything that touches the Grid or AntGrid objects while the thread is running.  The
+    //thread holds it while it moves the ant and copies the image.
+    QMutex gridMutex;
+
+signals:
+    void frameReady();
+
+protected:
+    void run();
+
+private:
+    Grid * displayGrid;
+    AntGrid * antGrid;
+    AntCounter * antCounter;
+    AntSettings * settings;
+
+    //The double buffer used to pass images to the GUI.  frontBuffer is the index of the buffer that the GUI reads.
+    QImage frameBuffers[2];
+    int frameTimes[2];
+    int frontBuffer;
+    QMutex bufferMutex;
+
+    //These are set from the GUI thread and read by the simulation thread, so they are atomic.
+    QAtomicInt stopRequested;
+    QAtomicInt framePending;
+    QAtomicInt stepsPerUpdate;
+    QAtomicInt delayPerUpdate;
+    QAtomicInt targetFpsPlayback;
+    QAtomicInt targetFps;
+    QAtomicInt stepsPerFrame;
+
+    //The measured speed of the simulation, in steps per second.  Only used by the simulation thread.
+    double measuredStepsPerSecond;
+
+    int chooseStepCount();
+    void copyToBackBuffer();
+};
+
+#endif // SIMULATIONTHREAD_H
@@ -1,41 +1,51 @@
-#ifndef STATEWIDGET_H
-#define STATEWIDGET_H
-
-#include <QWidget>
-#include <QtWidgets>
-#include "antdirection.h"
-
-namespace Ui {
-class StateWidget;
-}
-
-class StateWidget : public QWidget
-{
-    Q_OBJECT
-    
-public:
-    explicit StateWidget(QWidget *parent = 0);
-    ~StateWidget();
-
-    QColor color;
-    AntDirection direction;
-    bool initialized;
-
-    void initialize(int numberToSet, AntDirection directionToSet, QColor colorToSet);
-    void changeColor(QColor colorToSet);
-    
-private slots:
-    void colorButtonPushed();
-    void rightSelected();
-    void leftSelected();
-    void backSelected();
-
-signals:
-    void colorChanged();
-    void directionChanged();
-
-private:
-    Ui::StateWidget *ui;
-};
-
-#endif // STATEWIDGET_H
+#ifndef STATEWIDGET_H
+#define STATEWIDGET_H
+
+#include <QWidget>
+#include <QtWidgets>
+#include <QMutex>
+#include "antdirection.h"
+#include "staterule.h"
+
+namespace Ui {
+class StateWidget;
+}
+
+class StateWidget : public QWidget
+{
+    Q_OBJECT
+    
+public:
+    explicit StateWidget(QWidget *parent = 0);
+    ~StateWidget();
+
+    QColor color;
+    AntDirection direction;
+    bool initialized;
+
+    void initialize(int numberToSet, AntDirection directionToSet, QColor colorToSet);
+    void changeColor(QColor colorToSet);
+    void setRule(StateRule * ruleP, QMutex * ruleMutexP = 0);
+    
+private slots:
+    void colorButtonPushed();
+    void rightSelected();
+    void leftSelected();
+    void backSelected();
+
+signals:
+    void colorChanged();
+    void directionChanged();
+
+private:
+    Ui::StateWidget *ui;
+
+    //The rule that the simulation uses for this state.  Every change made to the widget is copied into it, with
+    //ruleMutex held if there is one, as the simulation may be reading the rules on another thread.
+    StateRule * rule;
+    QMutex * ruleMutex;
+
+    void updateRule();
+};
+
+#endif // STATEWIDGET_H
@@ -0,0 +1,160 @@
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QVector>
+
+#include "rulesearch.h"
+
+//This program checks RuleSearch's numbering of the canonical rules.  For small state counts it goes through every rule
+//in the order the "all" search uses and checks that the canonical ones are numbered 0, 1, 2... by patternIndex and made
+//again by setSequentialRules.  It also checks the rule counts, and the rules at either end of the range for the
+//largest state counts that fit in 64 bits.
+
+static QTextStream out(stdout);
+static int failures = 0;
+
+static void check(bool passed, const QString & description)
+{
+    if (!passed)
+    {
+        out << "FAILED: " << description << Qt::endl;
+        failures++;
+    }
+}
+
+
+
+
+
+static QString turnString(const QVector<StateRule> & rules)
+{
+    QString turns;
+    for (int i = 0; i < rules.size(); i++)
+        turns += (rules[i].direction == antRight) ? "R" : ( (rules[i].direction == antLeft) ? "L" : "B" );
+    return turns;
+}
+
+//The rule count worked out directly: (3^n + 1)/2 with U-turns and 2^(n-1) without
+static quint64 expectedCount(int stateCount, bool includeBack)
+{
+    quint64 count = 1;
+    for (int i = 0; i < stateCount; i++)
+        count *= includeBack ? 3 : 2;
+    return includeBack ? (count + 1) / 2 : count / 2;
+}
+
+
+
+
+
+//Goes through every rule with stateCount states, with the turns read as a number (R, B, L as digits, state 1 first),
+//and checks the numbering of the canonical ones
+static void checkEveryRule(int stateCount, bool includeBack)
+{
+    RuleSearch ruleSearch;
+    ruleSearch.seed(1);
+    QString name = QString::number(stateCount) + (includeBack ? " states with U-turns" : " states");
+
+    AntDirection turns[3] = {antRight, antBack, antLeft};
+    if (!includeBack)
+        turns[1] = antLeft;
+    int digitCount = includeBack ? 3 : 2;
+
+    quint64 ruleCount = 1;
+    for (int i = 0; i < stateCount; i++)
+        ruleCount *= digitCount;
+
+    QVector<StateRule> rules(stateCount);
+    QVector<StateRule> madeRules(stateCount);
+    quint64 nextIndex = 0;
+    for (quint64 number = 0; number < ruleCount; number++)
+    {
+        quint64 remaining = number;
+        for (int i = stateCount - 1; i >= 0; i--)
+        {
+            rules[i].direction = turns[remaining % digitCount];
+            remaining /= digitCount;
+        }
+        if (RuleSearch::startsWithLeft(rules.data(), stateCount))
+            continue;
+
+        quint64 index = RuleSearch::patternIndex(rules.data(), stateCount, includeBack);
+        check(index == nextIndex, name + ": " + turnString(rules) + " has index " + QString::number(index) + ", not "
+                                  + QString::number(nextIndex));
+
+        ruleSearch.setSequentialRules(madeRules.data(), stateCount, includeBack, nextIndex);
+        check(turnString(madeRules) == turnString(rules), name + ": index " + QString::number(nextIndex) + " made "
+                                                          + turnString(madeRules) + ", not " + turnString(rules));
+        nextIndex++;
+    }
+
+    check(nextIndex == expectedCount(stateCount, includeBack), name + ": " + QString::number(nextIndex) + " canonical rules");
+    check(RuleSearch::patternCountForAll(stateCount, includeBack) == nextIndex,
+          name + ": patternCountForAll gives " + QString::number(RuleSearch::patternCountForAll(stateCount, includeBack)));
+}
+
+
+
+
+
+//Makes the rule with the given index and checks that it is canonical, has the index and (if given) has the turns
+static void checkIndex(int stateCount, bool includeBack, quint64 index, const QString & expectedTurns = QString())
+{
+    RuleSearch ruleSearch;
+    ruleSearch.seed(1);
+    QString name = QString::number(stateCount) + (includeBack ? " states with U-turns" : " states") + ", index "
+                   + QString::number(index);
+
+    QVector<StateRule> rules(stateCount);
+    ruleSearch.setSequentialRules(rules.data(), stateCount, includeBack, index);
+    check(!RuleSearch::startsWithLeft(rules.data(), stateCount), name + ": " + turnString(rules) + " isn't canonical");
+    check(RuleSearch::patternIndex(rules.data(), stateCount, includeBack) == index,
+          name + ": " + turnString(rules) + " has index " + QString::number(RuleSearch::patternIndex(rules.data(), stateCount, includeBack)));
+    if (!expectedTurns.isEmpty())
+        check(turnString(rules) == expectedTurns, name + ": made " + turnString(rules) + ", not " + expectedTurns);
+}
+
+
+
+
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    //Every rule, for as many states as can be gone through quickly
+    for (int stateCount = 2; stateCount <= 9; stateCount++)
+        checkEveryRule(stateCount, true);
+    for (int stateCount = 2; stateCount <= 14; stateCount++)
+        checkEveryRule(stateCount, false);
+
+    //The counts, up to where they still fit in 64 bits when worked out directly
+    for (int stateCount = 2; stateCount <= 40; stateCount++)
+        check(RuleSearch::patternCountForAll(stateCount, true) == expectedCount(stateCount, true),
+              QString::number(stateCount) + " states with U-turns: wrong count");
+    for (int stateCount = 2; stateCount <= 63; stateCount++)
+        check(RuleSearch::patternCountForAll(stateCount, false) == expectedCount(stateCount, false),
+              QString::number(stateCount) + " states: wrong count");
+
+    //The largest state counts with 64-bit indexes.  3^41 doesn't fit, but (3^41 + 1)/2 does.  The first rule is all
+    //rights, and the last is all U-turns with them and a right then all lefts without.
+    check(RuleSearch::maxStateCountForAll(true) == 41, "maxStateCountForAll with U-turns isn't 41");
+    check(RuleSearch::maxStateCountForAll(false) == 64, "maxStateCountForAll without U-turns isn't 64");
+
+    quint64 count41 = Q_UINT64_C(18236498188585393202);
+    check(RuleSearch::patternCountForAll(41, true) == count41, "41 states with U-turns: wrong count");
+    checkIndex(41, true, 0, QString(41, 'R'));
+    checkIndex(41, true, 1);
+    checkIndex(41, true, count41 / 2);
+    checkIndex(41, true, count41 - 2);
+    checkIndex(41, true, count41 - 1, QString(41, 'B'));
+
+    quint64 count64 = Q_UINT64_C(9223372036854775808);
+    check(RuleSearch::patternCountForAll(64, false) == count64, "64 states: wrong count");
+    checkIndex(64, false, 0, QString(64, 'R'));
+    checkIndex(64, false, 1);
+    checkIndex(64, false, count64 / 2);
+    checkIndex(64, false, count64 - 1, "R" + QString(63, 'L'));
+
+    out << (failures == 0 ? "All checks passed." : QString::number(failures) + " checks failed!") << Qt::endl;
+    return (failures == 0) ? 0 : 1;
+}
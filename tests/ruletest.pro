@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# Checks the rule numbering used by the "all" pattern search.  Run it from a terminal; it returns 1 if a check fails.
+#
+#-------------------------------------------------
+
+QT       += core gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = ruletest
+TEMPLATE = app
+
+include(../core/core.pri)
+
+SOURCES += ruletest.cpp